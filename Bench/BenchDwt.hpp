@@ -0,0 +1,234 @@
+#ifndef SIGNAL_PROCESSOR_BENCH_DWT_HPP_
+#define SIGNAL_PROCESSOR_BENCH_DWT_HPP_
+
+#include <new>
+
+#include "SignalProcessor.hpp"
+#include "SignalProcessorBank.hpp"
+#include "BenchSignals.hpp"
+
+/**
+ * @brief Вимір тактів SignalProcessor на Cortex-M через лічильник DWT->CYCCNT
+ *
+ * Header-only, без STL і без динамічної алокації: процесори по черзі
+ * створюються в одній статичній області (SP_BENCH_DWT_ARENA байт), тому RAM
+ * визначає найбільший процесор, а не сума всіх конфігурацій. Конфігурації, які
+ * не вміщаються в область (наприклад, N = 65535), пропускаються.
+ *
+ *   static void report(const char* bench, const char* type, uint32_t n,
+ *                      const char* shape, uint32_t cycles) {
+ *       printf("%s %s N=%lu %s: %lu\n", bench, type, (unsigned long)n, shape, (unsigned long)cycles);
+ *   }
+ *   ...
+ *   sp_bench::DwtBench<>::run(report);   // після ініціалізації UART, до запуску RTOS
+ *
+ * Для всіх комбінацій float / int16_t / uint16_t, N = 16, 256, 4096, 65535 і
+ * форм Ramp / Noise / Spikes звітуються:
+ *   add          - такти на значення, середнє по блоку kBlock
+ *   addBlock     - такти на значення для блоку з kBlock значень
+ *   getMinEvict  - найгірший getMin() після витіснення мінімуму (пилка; лінивий і MinMaxWedge)
+ *   getStats     - такти на виклик
+ *   bankAddFrame - такти на кадр банку з 4 і 16 каналів
+ * Із значень віднято такти порожнього виміру (start/stop лічильника).
+ * Викликати з вимкненими перериваннями або без них на час виміру.
+ */
+
+#ifndef SP_BENCH_DWT_ARENA
+#define SP_BENCH_DWT_ARENA (48u * 1024u)
+#endif
+
+namespace sp_bench {
+
+/** DWT->CYCCNT (Cortex-M3/M4/M7/M33/M55) без залежності від CMSIS */
+struct DwtCounter {
+    static volatile uint32_t& demcr() { return *(volatile uint32_t*)0xE000EDFCu; }
+    static volatile uint32_t& ctrl() { return *(volatile uint32_t*)0xE0001000u; }
+    static volatile uint32_t& cyccnt() { return *(volatile uint32_t*)0xE0001004u; }
+    static volatile uint32_t& lar() { return *(volatile uint32_t*)0xE0001FB0u; }
+
+    static void enable() {
+        demcr() |= 1u << 24;        // TRCENA
+        lar() = 0xC5ACCE55u;        // Розблокування DWT (Cortex-M7)
+        cyccnt() = 0;
+        ctrl() |= 1u;               // CYCCNTENA
+    }
+
+    static uint32_t now() { return cyccnt(); }
+};
+
+template<typename T> struct TypeName { static const char* value() { return "?"; } };
+template<> struct TypeName<float> { static const char* value() { return "float"; } };
+template<> struct TypeName<int16_t> { static const char* value() { return "int16_t"; } };
+template<> struct TypeName<uint16_t> { static const char* value() { return "uint16_t"; } };
+
+/** Звіт одного виміру: такти на операцію */
+typedef void (*DwtReport)(const char* bench, const char* type, uint32_t n,
+                          const char* shape, uint32_t cycles);
+
+/**
+ * Набір вимірів
+ * Counter - джерело тактів з enable() і now() (DwtCounter; для перевірки на host - будь-який)
+ */
+template<typename Counter = DwtCounter>
+class DwtBench {
+public:
+    static const uint32_t kBlock = 64;          // Значень в одному вимірі
+
+    /** Усі виміри */
+    static void run(DwtReport report) {
+        Counter::enable();
+        calibrate();
+        runType<float>(report);
+        runType<int16_t>(report);
+        runType<uint16_t>(report);
+        runBank<4>(report);
+        runBank<16>(report);
+    }
+
+private:
+    union Arena {
+        uint8_t bytes[SP_BENCH_DWT_ARENA];
+        uint64_t align;
+        double alignD;
+    };
+
+    static Arena& arena() {
+        static Arena a;
+        return a;
+    }
+
+    static uint32_t& overhead() {
+        static uint32_t o = 0;
+        return o;
+    }
+
+    /** Такти порожнього виміру */
+    static void calibrate() {
+        uint32_t best = 0xFFFFFFFFu;
+        for (int k = 0; k < 8; k++) {
+            uint32_t t0 = Counter::now();
+            uint32_t t1 = Counter::now();
+            if (t1 - t0 < best) best = t1 - t0;
+        }
+        overhead() = best;
+    }
+
+    static uint32_t elapsed(uint32_t t0) {
+        uint32_t dt = Counter::now() - t0;
+        return (dt > overhead()) ? dt - overhead() : 0;
+    }
+
+    /** Процесор у статичній області, заповнений першими N значеннями форми Shape */
+    template<typename P, typename T, uint32_t N, typename Shape>
+    static P& fill() {
+        P& p = *new (arena().bytes) P();
+        T block[kBlock];
+        for (uint32_t i = 0; i < N; i += kBlock) {
+            uint32_t len = (N - i < kBlock) ? N - i : kBlock;
+            fillSignal<Shape>(block, len, i);
+            p.addBlock(block, len);
+        }
+        return p;
+    }
+
+    template<typename T, uint32_t N, typename Shape>
+    static void measureShape(DwtReport report) {
+        typedef SignalProcessor<T, N> P;
+        T block[kBlock];
+
+        // add(): середнє по блоку
+        P& p = fill<P, T, N, Shape>();
+        fillSignal<Shape>(block, kBlock, N);
+        uint32_t t0 = Counter::now();
+        for (uint32_t i = 0; i < kBlock; i++) p.add(block[i]);
+        report("add", TypeName<T>::value(), N, Shape::name(), elapsed(t0) / kBlock);
+
+        // addBlock(): такти на значення
+        fillSignal<Shape>(block, kBlock, N + kBlock);
+        t0 = Counter::now();
+        p.addBlock(block, kBlock);
+        report("addBlock", TypeName<T>::value(), N, Shape::name(), elapsed(t0) / kBlock);
+
+        // getStats(): після кожного add() знімок рахується заново
+        uint32_t total = 0;
+        fillSignal<Shape>(block, kBlock, N + 2 * kBlock);
+        for (uint32_t i = 0; i < kBlock; i++) {
+            p.add(block[i]);
+            t0 = Counter::now();
+            volatile float sd = p.getStats().stdDev;
+            (void)sd;
+            total += elapsed(t0);
+        }
+        report("getStats", TypeName<T>::value(), N, Shape::name(), total / kBlock);
+    }
+
+    /** Найгірший getMin() після витіснення мінімуму на неспадній пилці */
+    template<typename T, uint32_t N, uint32_t Features>
+    static void measureMinEviction(DwtReport report, const char* label) {
+        typedef SignalProcessor<T, N, Features> P;
+        P& p = fill<P, T, N, Ramp>();
+        T block[kBlock];
+        fillSignal<Ramp>(block, kBlock, N);
+        uint32_t worst = 0;
+        for (uint32_t i = 0; i < kBlock; i++) {
+            p.add(block[i]);
+            uint32_t t0 = Counter::now();
+            volatile T lo = p.getMin();
+            (void)lo;
+            uint32_t dt = elapsed(t0);
+            if (dt > worst) worst = dt;
+        }
+        report("getMinEvict", TypeName<T>::value(), N, label, worst);
+    }
+
+    /** Конфігурація вміщається в статичну область */
+    template<uint32_t Bytes>
+    struct Fits {
+        static const bool value = Bytes <= SP_BENCH_DWT_ARENA;
+    };
+
+    template<typename T, uint32_t N, bool Enabled = Fits<sizeof(SignalProcessor<T, N,
+        SignalFeatures::Default | SignalFeatures::MinMaxWedge>)>::value>
+    struct Size {
+        static void run(DwtReport report) {
+            measureShape<T, N, Ramp>(report);
+            measureShape<T, N, Noise>(report);
+            measureShape<T, N, Spikes>(report);
+            measureMinEviction<T, N, SignalFeatures::Default>(report, "Lazy");
+            measureMinEviction<T, N, SignalFeatures::Default | SignalFeatures::MinMaxWedge>(report, "Wedge");
+        }
+    };
+
+    template<typename T, uint32_t N>
+    struct Size<T, N, false> {
+        static void run(DwtReport) {}
+    };
+
+    template<typename T>
+    static void runType(DwtReport report) {
+        Size<T, 16>::run(report);
+        Size<T, 256>::run(report);
+        Size<T, 4096>::run(report);
+        Size<T, 65535>::run(report);
+    }
+
+    template<uint16_t Channels>
+    static void runBank(DwtReport report) {
+        typedef SignalProcessorBank<int16_t, 256, Channels> B;
+        static_assert(sizeof(B) <= SP_BENCH_DWT_ARENA, "SP_BENCH_DWT_ARENA is too small for the bank benchmark");
+        B& bank = *new (arena().bytes) B();
+        int16_t frame[Channels];
+        uint32_t total = 0;
+        for (uint32_t f = 0; f < 256 + kBlock; f++) {
+            fillSignal<Noise>(frame, Channels, f * Channels);
+            uint32_t t0 = Counter::now();
+            bank.addFrame(frame);
+            if (f >= 256) total += elapsed(t0);     // Тільки заповнене вікно
+        }
+        report("bankAddFrame", "int16_t", Channels, "Noise", total / kBlock);     // n - кількість каналів
+    }
+};
+
+} // namespace sp_bench
+
+#endif
@@ -0,0 +1,280 @@
+/**
+ * Мікробенчмарки SignalProcessor на host (Google Benchmark)
+ *
+ * Типи float / int16_t / uint16_t, вікна N = 16, 256, 4096, 65535,
+ * форми сигналу Ramp / Noise / Spikes (BenchSignals.hpp).
+ * Запуск окремої групи: ./signal_processor_bench --benchmark_filter=BM_AddGetMin
+ */
+#include <benchmark/benchmark.h>
+
+#include "SignalProcessor.hpp"
+#include "SignalProcessorBank.hpp"
+#include "SignalProcessorBatch.hpp"
+#include "BenchSignals.hpp"
+
+using namespace sp_bench;
+
+namespace {
+
+/** Довжина згенерованого сигналу: один період Ramp, маска замість ділення */
+const uint32_t kSignalLength = 131072;
+const uint32_t kSignalMask = kSignalLength - 1;
+
+/** Сигнал форми Shape, згенерований один раз на пару (T, Shape) */
+template<typename T, typename Shape>
+const T* signal() {
+    static T samples[kSignalLength];
+    static bool ready = false;
+    if (!ready) {
+        fillSignal<Shape>(samples, kSignalLength);
+        ready = true;
+    }
+    return samples;
+}
+
+/** Процесор, заповнений першими N значеннями сигналу (статичний - N до 65535 не вміщається в стек) */
+template<typename P, typename T, uint32_t N, typename Shape>
+P& filledProcessor() {
+    static P p;
+    p.reset();
+    p.addBlock(signal<T, Shape>(), N);
+    return p;
+}
+
+const uint32_t kWedge = SignalFeatures::Default | SignalFeatures::MinMaxWedge;
+const uint32_t kGetters = SignalFeatures::Default | SignalFeatures::Median;
+
+// ========================================
+// ДОДАВАННЯ ДАНИХ
+// ========================================
+
+/** add() по одному значенню в заповнене вікно (кожен виклик витісняє найстаріше) */
+template<typename T, uint32_t N, typename Shape>
+void BM_Add(benchmark::State& state) {
+    typedef SignalProcessor<T, N> P;
+    P& p = filledProcessor<P, T, N, Shape>();
+    const T* x = signal<T, Shape>();
+    uint32_t i = N;
+    for (auto _ : state) {
+        p.add(x[i & kSignalMask], i);
+        i++;
+    }
+    benchmark::DoNotOptimize(p);
+    state.SetItemsProcessed(state.iterations());
+}
+
+/** addBlock() блоками по 256 значень (половина DMA-буфера АЦП) */
+template<typename T, uint32_t N, typename Shape>
+void BM_AddBlock(benchmark::State& state) {
+    typedef SignalProcessor<T, N> P;
+    const uint32_t kBlock = 256;
+    P& p = filledProcessor<P, T, N, Shape>();
+    const T* x = signal<T, Shape>();
+    uint32_t i = N & ~(kBlock - 1);
+    for (auto _ : state) {
+        p.addBlock(x + (i & kSignalMask), kBlock, i, 1);
+        i += kBlock;
+    }
+    benchmark::DoNotOptimize(p);
+    state.SetItemsProcessed(state.iterations() * kBlock);
+}
+
+/**
+ * add() + getMin() на пилці: кожне значення витісняє мінімум вікна,
+ * тому лінивий min/max перераховує весь буфер (найгірший випадок), а MinMaxWedge - ні
+ */
+template<typename T, uint32_t N, uint32_t Features>
+void BM_AddGetMin(benchmark::State& state) {
+    typedef SignalProcessor<T, N, Features> P;
+    P& p = filledProcessor<P, T, N, Ramp>();
+    const T* x = signal<T, Ramp>();
+    uint32_t i = N;
+    for (auto _ : state) {
+        p.add(x[i]);
+        benchmark::DoNotOptimize(p.getMin());
+        // Після спаду пилки (раз на період) мінімум не витісняється - починаємо вікно заново
+        if (++i == kSignalLength) {
+            p.addBlock(x, N);
+            i = N;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/** add() + getStats() на кожне значення: типовий цикл "семпл - рішення" */
+template<typename T, uint32_t N, typename Shape>
+void BM_AddGetStats(benchmark::State& state) {
+    typedef SignalProcessor<T, N> P;
+    P& p = filledProcessor<P, T, N, Shape>();
+    const T* x = signal<T, Shape>();
+    uint32_t i = N;
+    for (auto _ : state) {
+        p.add(x[i & kSignalMask]);
+        benchmark::DoNotOptimize(p.getStats());
+        i++;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// ========================================
+// GETTER-И
+// ========================================
+
+#define SP_BENCH_GETTER(Name, expr)                                   \
+    struct Name {                                                     \
+        template<typename P> static float get(const P& p) { return (float)(expr); } \
+    };
+
+SP_BENCH_GETTER(GetMean, p.getMean())
+SP_BENCH_GETTER(GetVariance, p.getVariance())
+SP_BENCH_GETTER(GetStdDev, p.getStdDev())
+SP_BENCH_GETTER(GetCoefficientOfVariation, p.getCoefficientOfVariation())
+SP_BENCH_GETTER(GetMin, p.getMin())
+SP_BENCH_GETTER(GetMax, p.getMax())
+SP_BENCH_GETTER(GetRange, p.getRange())
+SP_BENCH_GETTER(GetStats, p.getStats().stdDev)
+SP_BENCH_GETTER(GetEma, p.getEma())
+SP_BENCH_GETTER(GetLowpass, p.getLowpass())
+SP_BENCH_GETTER(GetDerivative, p.getDerivative())
+SP_BENCH_GETTER(GetIntegral, p.getIntegral())
+SP_BENCH_GETTER(GetMedian, p.getMedian())
+SP_BENCH_GETTER(GetPercentile90, p.getPercentile(90.0f))
+SP_BENCH_GETTER(GetMAD, p.getMAD())
+SP_BENCH_GETTER(IsOutlier, p.isOutlier(p.getLastValue()))
+
+#undef SP_BENCH_GETTER
+
+/** Окремий getter на заповненому вікні шуму, без add() між викликами */
+template<typename T, uint32_t N, typename Getter>
+void BM_Getter(benchmark::State& state) {
+    typedef SignalProcessor<T, N, kGetters> P;
+    P& p = filledProcessor<P, T, N, Noise>();
+    for (auto _ : state) {
+        benchmark::ClobberMemory();
+        benchmark::DoNotOptimize(Getter::get(p));
+    }
+}
+
+// ========================================
+// БАНК КАНАЛІВ
+// ========================================
+
+/** addFrame() банку з Channels каналів: кадр сканування АЦП */
+template<typename T, uint32_t N, uint16_t Channels>
+void BM_BankAddFrame(benchmark::State& state) {
+    typedef SignalProcessorBank<T, N, Channels> B;
+    static B bank;
+    static T frames[kSignalLength];
+    fillSignal<Noise>(frames, kSignalLength);
+    bank.reset();
+    const uint32_t kFrames = kSignalLength / Channels;
+    uint32_t f = 0;
+    for (auto _ : state) {
+        bank.addFrame(frames + (size_t)(f % kFrames) * Channels);
+        f++;
+    }
+    benchmark::DoNotOptimize(bank);
+    state.SetItemsProcessed(state.iterations() * Channels);
+}
+
+/** addFrames() банку блоками по 32 кадри */
+template<typename T, uint32_t N, uint16_t Channels>
+void BM_BankAddFrames(benchmark::State& state) {
+    typedef SignalProcessorBank<T, N, Channels> B;
+    const uint32_t kBlockFrames = 32;
+    static B bank;
+    static T frames[kSignalLength];
+    fillSignal<Noise>(frames, kSignalLength);
+    bank.reset();
+    const uint32_t kBlocks = kSignalLength / (Channels * kBlockFrames);
+    uint32_t b = 0;
+    for (auto _ : state) {
+        bank.addFrames(frames + (size_t)(b % kBlocks) * Channels * kBlockFrames, kBlockFrames);
+        b++;
+    }
+    benchmark::DoNotOptimize(bank);
+    state.SetItemsProcessed(state.iterations() * Channels * kBlockFrames);
+}
+
+// ========================================
+// ПАКЕТНА ОБРОБКА (SignalProcessorBatch)
+// ========================================
+
+/**
+ * Матриця 4096 каналів x 256 кадрів через пул з state.range(0) потоків:
+ * items/s має рости лінійно з кількістю потоків до кількості ядер
+ */
+template<typename T, uint32_t N>
+void BM_BatchProcess(benchmark::State& state) {
+    typedef SignalProcessor<T, N> P;
+    const size_t kChannels = 4096;
+    const size_t kFrames = 256;
+    static SignalChannel<P> channels[kChannels];
+    static T matrix[kChannels * kFrames];
+    fillSignal<Noise>(matrix, kChannels * kFrames);
+    SignalProcessorBatch batch((unsigned)state.range(0));
+    for (auto _ : state) {
+        batch.process(channels, kChannels, matrix, kFrames);
+    }
+    benchmark::DoNotOptimize(channels);
+    state.SetItemsProcessed(state.iterations() * kChannels * kFrames);
+}
+
+} // namespace
+
+// ========================================
+// РЕЄСТРАЦІЯ: T x N (x форма сигналу)
+// ========================================
+
+#define SP_BENCH_SIZES(func, T, ...)                \
+    BENCHMARK_TEMPLATE(func, T, 16, __VA_ARGS__);   \
+    BENCHMARK_TEMPLATE(func, T, 256, __VA_ARGS__);  \
+    BENCHMARK_TEMPLATE(func, T, 4096, __VA_ARGS__); \
+    BENCHMARK_TEMPLATE(func, T, 65535, __VA_ARGS__)
+
+#define SP_BENCH_TYPES(func, ...)                   \
+    SP_BENCH_SIZES(func, float, __VA_ARGS__);       \
+    SP_BENCH_SIZES(func, int16_t, __VA_ARGS__);     \
+    SP_BENCH_SIZES(func, uint16_t, __VA_ARGS__)
+
+#define SP_BENCH_SHAPES(func)                       \
+    SP_BENCH_TYPES(func, Ramp);                     \
+    SP_BENCH_TYPES(func, Noise);                    \
+    SP_BENCH_TYPES(func, Spikes)
+
+SP_BENCH_SHAPES(BM_Add);
+SP_BENCH_SHAPES(BM_AddBlock);
+SP_BENCH_SHAPES(BM_AddGetStats);
+
+SP_BENCH_TYPES(BM_AddGetMin, SignalFeatures::Default);
+SP_BENCH_TYPES(BM_AddGetMin, kWedge);
+
+SP_BENCH_TYPES(BM_Getter, GetMean);
+SP_BENCH_TYPES(BM_Getter, GetVariance);
+SP_BENCH_TYPES(BM_Getter, GetStdDev);
+SP_BENCH_TYPES(BM_Getter, GetCoefficientOfVariation);
+SP_BENCH_TYPES(BM_Getter, GetMin);
+SP_BENCH_TYPES(BM_Getter, GetMax);
+SP_BENCH_TYPES(BM_Getter, GetRange);
+SP_BENCH_TYPES(BM_Getter, GetStats);
+SP_BENCH_TYPES(BM_Getter, GetEma);
+SP_BENCH_TYPES(BM_Getter, GetLowpass);
+SP_BENCH_TYPES(BM_Getter, GetDerivative);
+SP_BENCH_TYPES(BM_Getter, GetIntegral);
+SP_BENCH_TYPES(BM_Getter, GetMedian);
+SP_BENCH_TYPES(BM_Getter, GetPercentile90);
+SP_BENCH_TYPES(BM_Getter, GetMAD);
+SP_BENCH_TYPES(BM_Getter, IsOutlier);
+
+BENCHMARK_TEMPLATE(BM_BankAddFrame, int16_t, 256, 4);
+BENCHMARK_TEMPLATE(BM_BankAddFrame, int16_t, 256, 16);
+BENCHMARK_TEMPLATE(BM_BankAddFrame, uint16_t, 256, 16);
+BENCHMARK_TEMPLATE(BM_BankAddFrame, float, 256, 16);
+BENCHMARK_TEMPLATE(BM_BankAddFrames, int16_t, 256, 16);
+BENCHMARK_TEMPLATE(BM_BankAddFrames, uint16_t, 256, 16);
+BENCHMARK_TEMPLATE(BM_BankAddFrames, float, 256, 16);
+
+BENCHMARK_TEMPLATE(BM_BatchProcess, int16_t, 256)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_BatchProcess, float, 256)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,67 @@
+#ifndef SIGNAL_PROCESSOR_BENCH_SIGNALS_HPP_
+#define SIGNAL_PROCESSOR_BENCH_SIGNALS_HPP_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief Форми тестових сигналів для бенчмарків (спільні для host і DWT)
+ *
+ * Кожна форма - детермінована функція індексу at<T>(i) без стану, тому host
+ * генерує з неї масив, а DWT-харнес на МК - короткий блок перед кожним виміром.
+ *
+ *   Ramp   - неспадна пилка через весь 16-бітний діапазон (крок 1 на 2 семпли,
+ *            період 131072): найстаріше значення вікна - його мінімум, тому при
+ *            N до 65535 кожен add() витісняє min (найгірший випадок лінивого min/max)
+ *   Noise  - рівномірний 10-бітний шум навколо середини 12-бітної шкали АЦП
+ *   Spikes - той самий шум з викидом до верхньої межі шкали раз на 64 семпли
+ */
+namespace sp_bench {
+
+/** Зсув шкали: для int16_t пилка йде від -32768, для інших типів - від 0 */
+template<typename T> struct RampOffset { static const int32_t value = 0; };
+template<> struct RampOffset<int16_t> { static const int32_t value = -32768; };
+
+/** Хеш індексу (lowbias32) - псевдовипадкове значення без стану генератора */
+inline uint32_t hashIndex(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x7FEB352Du;
+    x ^= x >> 15;
+    x *= 0x846CA68Bu;
+    x ^= x >> 16;
+    return x;
+}
+
+struct Ramp {
+    static const char* name() { return "Ramp"; }
+
+    template<typename T>
+    static T at(uint32_t i) { return (T)((int32_t)((i >> 1) & 0xFFFFu) + RampOffset<T>::value); }
+};
+
+struct Noise {
+    static const char* name() { return "Noise"; }
+
+    template<typename T>
+    static T at(uint32_t i) { return (T)(1536u + (hashIndex(i) & 1023u)); }
+};
+
+struct Spikes {
+    static const char* name() { return "Spikes"; }
+
+    template<typename T>
+    static T at(uint32_t i) {
+        uint32_t r = hashIndex(i);
+        return ((i & 63u) == 0) ? (T)(3584u + (r >> 23)) : (T)(1536u + (r & 1023u));
+    }
+};
+
+/** Заповнення масиву значеннями форми Shape з індексу start */
+template<typename Shape, typename T>
+void fillSignal(T* out, size_t n, uint32_t start = 0) {
+    for (size_t i = 0; i < n; i++) out[i] = Shape::template at<T>(start + (uint32_t)i);
+}
+
+} // namespace sp_bench
+
+#endif
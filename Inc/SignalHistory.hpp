@@ -0,0 +1,326 @@
+#ifndef SIGNAL_HISTORY_HPP_
+#define SIGNAL_HISTORY_HPP_
+
+#include "SignalProcessor.hpp"
+
+/**
+ * @brief Агрегат ділянки сигналу: min, max, кількість, сума, сума квадратів
+ *
+ * Агрегати сусідніх ділянок об'єднуються без втрат (merge()), тому з агрегатів
+ * дрібного рівня отримуються точні агрегати грубшого.
+ * Суми - у типі sp_detail::SumTraits<T>: int64_t для 8/16-бітних T (точно),
+ * double для 32-бітних, float для float.
+ */
+template<typename T>
+struct HistoryAggregate {
+    typedef typename sp_detail::SumTraits<T>::type Sum;
+
+    T min;                  // Мінімум ділянки
+    T max;                  // Максимум ділянки
+    uint32_t count;         // Кількість семплів
+    Sum sum;                // Сума значень
+    Sum sumSq;              // Сума квадратів
+
+    HistoryAggregate() { reset(); }
+
+    void reset() {
+        min = max = 0;
+        count = 0;
+        sum = sumSq = 0;
+    }
+
+    bool empty() const { return count == 0; }
+
+    /** Додавання одного семпла */
+    void add(T x) {
+        if (count == 0) {
+            min = max = x;
+        } else {
+            if (x < min) min = x;
+            if (x > max) max = x;
+        }
+        count++;
+        sum += (Sum)x;
+        sumSq += (Sum)x * (Sum)x;
+    }
+
+    /** Об'єднання з агрегатом сусідньої ділянки */
+    void merge(const HistoryAggregate& other) {
+        if (other.count == 0) return;
+        if (count == 0) {
+            min = other.min;
+            max = other.max;
+        } else {
+            if (other.min < min) min = other.min;
+            if (other.max > max) max = other.max;
+        }
+        count += other.count;
+        sum += other.sum;
+        sumSq += other.sumSq;
+    }
+
+    /** Середнє */
+    float mean() const {
+        return (count > 0) ? (float)((double)sum / (double)count) : 0.0f;
+    }
+
+    /** Sample variance (незміщена оцінка, як SignalProcessor::getVariance()) */
+    float variance() const {
+        if (count <= 1) return 0.0f;
+        double m = (double)sum / (double)count;
+        double var = ((double)sumSq - (double)count * m * m) / (double)(count - 1);
+        return (var > 0) ? (float)var : 0.0f;
+    }
+
+    float stdDev() const { return sqrtf(variance()); }
+
+    float range() const { return (float)(max - min); }
+};
+
+namespace sp_detail {
+
+/** span * decimation^levels вміщується в uint32_t (множення в uint64_t не переповнюється) */
+constexpr bool historySpanFits(uint64_t span, uint32_t decimation, uint32_t levels) {
+    return levels == 0 || (span * decimation <= 0xFFFFFFFFu &&
+                           historySpanFits(span * decimation, decimation, levels - 1));
+}
+
+} // namespace sp_detail
+
+/**
+ * @brief Багаторівнева історія з децимацією (піраміда min/max/mean)
+ *
+ * Призначення:
+ *  - Тренди за останні секунди / хвилини / години при пам'яті на кілька сотень агрегатів
+ *  - Min/max і середнє за довгий інтервал без зберігання сирих семплів
+ *
+ * Кожні Decimation семплів add() записує агрегат {min, max, count, sum, sumSq}
+ * у кільце рівня 0; кожні Decimation агрегатів рівня k - агрегат у кільце рівня k + 1.
+ * Агрегат рівня k охоплює getSpan(k) = Decimation^(k+1) семплів, кільце рівня -
+ * останні Depth агрегатів, тобто Depth * getSpan(k) семплів історії.
+ *
+ * Вартість add(): O(1) амортизовано, O(Levels) у гіршому випадку (каскад на межі ділянок).
+ * Запит за довгий інтервал читає не більше Depth агрегатів і Levels незавершених.
+ *
+ * Шаблонні параметри:
+ *   T — тип даних
+ *   Decimation — кількість семплів / агрегатів попереднього рівня в одному агрегаті (від 2)
+ *   Levels — кількість рівнів (1 - 8)
+ *   Depth — кількість агрегатів у кільці кожного рівня (від 1)
+ *   Довжини, кількості семплів агрегатів і getLast() - uint32_t, тому вся історія
+ *   найгрубшого рівня, (Depth + 1) * Decimation^Levels семплів, має вміщатися в 32 біти
+ *
+ * Використання пам'яті: Levels * (Depth + 1) * sizeof(HistoryAggregate<T>) + Levels * 8 байт
+ *                       (sizeof(HistoryAggregate<int16_t>) = 24)
+ */
+template<typename T, uint32_t Decimation, uint8_t Levels, uint32_t Depth>
+class SignalHistory {
+    static_assert(Decimation >= 2, "Decimation must be at least 2");
+    static_assert(Levels >= 1 && Levels <= 8, "Levels must be 1 to 8");
+    static_assert(Depth >= 1, "Depth must be at least 1");
+    static_assert(sp_detail::historySpanFits((uint64_t)Depth + 1, Decimation, Levels),
+                  "(Depth + 1) * Decimation^Levels must fit in 32 bits");
+
+public:
+    typedef HistoryAggregate<T> Aggregate;
+    typedef typename sp_detail::Ring<Depth>::Index SizeType;
+
+private:
+    typedef sp_detail::Ring<Depth> Ring;
+    typedef typename sp_detail::KernelSelect<T, (Decimation >= 16)>::type Kernel;
+
+    Aggregate ring_[Levels][Depth];     // Завершені агрегати кожного рівня
+    Aggregate partial_[Levels];         // Незавершений агрегат кожного рівня
+    uint32_t parts_[Levels];            // Кількість семплів / агрегатів у partial_
+    SizeType index_[Levels];            // Позиція наступного запису в ring_
+    SizeType count_[Levels];            // Кількість агрегатів у ring_ (0 до Depth)
+
+    /** Незавершений агрегат рівня level закрито: запис у кільце і каскад вище */
+    void emit(uint8_t level) {
+        for (;;) {
+            ring_[level][index_[level]] = partial_[level];
+            index_[level] = Ring::next(index_[level]);
+            if (count_[level] < Depth) count_[level]++;
+
+            const Aggregate& done = partial_[level];
+            bool cascade = false;
+            if (level + 1 < Levels) {
+                partial_[level + 1].merge(done);
+                cascade = (++parts_[level + 1] == Decimation);
+            }
+            partial_[level].reset();
+            parts_[level] = 0;
+
+            if (!cascade) return;
+            level++;
+        }
+    }
+
+public:
+    /**
+     * Конструктор з порожньою історією
+     */
+    SignalHistory() { reset(); }
+
+    /**
+     * Додавання семпла
+     */
+    void add(T value) {
+        partial_[0].add(value);
+        if (++parts_[0] == Decimation) emit(0);
+    }
+
+    /**
+     * Пакетне додавання: кожна ділянка до межі агрегату - один прохід векторних ядер
+     */
+    void addBlock(const T* samples, size_t n) {
+        while (n > 0) {
+            uint32_t room = Decimation - parts_[0];
+            uint32_t len = (n < room) ? (uint32_t)n : room;
+
+            Aggregate a;
+            Kernel::minMax(samples, len, a.min, a.max);
+            typename Kernel::Sum s = 0, sq = 0;
+            Kernel::sums(samples, len, s, sq);
+            a.count = len;
+            a.sum = (typename Aggregate::Sum)s;
+            a.sumSq = (typename Aggregate::Sum)sq;
+            partial_[0].merge(a);
+
+            parts_[0] += len;
+            if (parts_[0] == Decimation) emit(0);
+            samples += len;
+            n -= len;
+        }
+    }
+
+    /**
+     * Повне скидання історії
+     */
+    void reset() {
+        for (uint8_t k = 0; k < Levels; k++) {
+            partial_[k].reset();
+            parts_[k] = 0;
+            index_[k] = 0;
+            count_[k] = 0;
+        }
+    }
+
+    // ========================================
+    // ЗАПИТИ
+    // ========================================
+
+    /** Кількість семплів в одному агрегаті рівня level: Decimation^(level+1) */
+    static uint32_t getSpan(uint8_t level) {
+        uint32_t span = Decimation;
+        for (uint8_t k = 0; k < level; k++) span *= Decimation;
+        return span;
+    }
+
+    /** Кількість завершених агрегатів у кільці рівня (0 до Depth) */
+    SizeType getCount(uint8_t level) const { return count_[level]; }
+
+    /**
+     * k-й завершений агрегат рівня від найновішого
+     * @param level Рівень (0 до Levels - 1)
+     * @param k 0 - найновіший, k < getCount(level)
+     */
+    const Aggregate& getAggregate(uint8_t level, SizeType k) const {
+        return ring_[level][Ring::advance(index_[level], Depth - 1 - k)];
+    }
+
+    /**
+     * Незавершена частина: усі семпли після останнього завершеного агрегату рівня level
+     * (об'єднання незавершених агрегатів рівнів 0..level)
+     */
+    Aggregate getPending(uint8_t level) const {
+        Aggregate a;
+        for (uint8_t k = 0; k <= level && k < Levels; k++) a.merge(partial_[k]);
+        return a;
+    }
+
+    /**
+     * Агрегат останніх count завершених агрегатів рівня level разом з незавершеною частиною
+     * @param level Рівень (0 до Levels - 1)
+     * @param count Кількість завершених агрегатів (обрізається до getCount(level))
+     */
+    Aggregate getRecent(uint8_t level, uint32_t count) const {
+        Aggregate a = getPending(level);
+        if (count > count_[level]) count = count_[level];
+        for (uint32_t k = 0; k < count; k++) a.merge(getAggregate(level, (SizeType)k));
+        return a;
+    }
+
+    /**
+     * Агрегат приблизно останніх samples семплів
+     * Обирається найдрібніший рівень, кільце якого покриває інтервал; межа інтервалу
+     * округлюється вгору до агрегату цього рівня. Якщо історії не вистачає -
+     * повертається все, що є на найгрубшому рівні.
+     */
+    Aggregate getLast(uint32_t samples) const {
+        uint8_t level = 0;
+        while (level + 1 < Levels && (uint64_t)Depth * getSpan(level) < samples) level++;
+
+        Aggregate pending = getPending(level);
+        uint32_t rest = (samples > pending.count) ? samples - pending.count : 0;
+        uint32_t span = getSpan(level);
+        return getRecent(level, (rest + span - 1) / span);
+    }
+};
+
+/**
+ * @brief SignalProcessor з багаторівневою історією
+ *
+ * add() / addBlock() оновлюють і статистику вікна N, і піраміду SignalHistory:
+ * останні N семплів - сирі дані процесора, довші інтервали - агрегати історії.
+ *
+ *   SignalProcessorHistory<int16_t, 1000, 10, 4, 60> ch;   // 100 Гц: 10 с сирих,
+ *   ch.add(adcValue, HAL_GetTick());                       // далі до 100 хв агрегатів
+ *   float minLast10Min = ch.history().getLast(60000).min;
+ */
+template<typename T, uint32_t N, uint32_t Decimation, uint8_t Levels, uint32_t Depth,
+         uint32_t Features = SignalFeatures::Default,
+         template<typename> class Accumulator = FloatAccumulator>
+class SignalProcessorHistory {
+public:
+    typedef SignalProcessor<T, N, Features, Accumulator> Processor;
+    typedef SignalHistory<T, Decimation, Levels, Depth> History;
+
+private:
+    Processor processor_;
+    History history_;
+
+public:
+    void add(T value) {
+        processor_.add(value);
+        history_.add(value);
+    }
+
+    void add(T value, uint32_t time) {
+        processor_.add(value, time);
+        history_.add(value);
+    }
+
+    void addBlock(const T* samples, size_t n) {
+        processor_.addBlock(samples, n);
+        history_.addBlock(samples, n);
+    }
+
+    void addBlock(const T* samples, size_t n, uint32_t startTime, uint32_t period) {
+        processor_.addBlock(samples, n, startTime, period);
+        history_.addBlock(samples, n);
+    }
+
+    void reset() {
+        processor_.reset();
+        history_.reset();
+    }
+
+    Processor& processor() { return processor_; }
+    const Processor& processor() const { return processor_; }
+
+    History& history() { return history_; }
+    const History& history() const { return history_; }
+};
+
+#endif
@@ -2,108 +2,3067 @@
 #define SIGNAL_PROCESSOR_HPP_
 
 #include <stdint.h>
+#include <stddef.h>
+#include <string.h>
 #include <math.h>
 
+// Категорія ітератора RingView для std:: алгоритмів - тільки якщо заголовок є (лише типи, без коду)
+#if !defined(SIGNAL_PROCESSOR_NO_STD) && defined(__has_include)
+#if __has_include(<iterator>)
+#include <iterator>
+#define SIGNAL_PROCESSOR_HAS_STD_ITERATOR 1
+#endif
+#endif
+
+/**
+ * SP_CONSTEXPR - constexpr з C++20 (цикли, зміна стану, __builtin_is_constant_evaluated()),
+ * інакше порожній. Позначені ним add(), addBlock(), getter-и статистики та генератори
+ * коефіцієнтів можна виконувати під час компіляції: еталонна статистика калібрувальних
+ * вікон і таблиці коефіцієнтів лягають у flash, перевірки - у static_assert.
+ * Під час компіляції працюють скалярні ядра і cx-варіанти sqrt/sin/cos; на виконанні
+ * код не змінюється (векторні ядра, sqrtf/sinf/cosf).
+ * SIGNAL_PROCESSOR_NO_CONSTEXPR - вимкнути і в C++20
+ */
+#if !defined(SIGNAL_PROCESSOR_NO_CONSTEXPR) && \
+    (__cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L))
+#define SP_CONSTEXPR constexpr
+#define SP_CONSTEXPR_ENABLED 1
+#else
+#define SP_CONSTEXPR
+#define SP_CONSTEXPR_ENABLED 0
+#endif
+
+namespace sp_detail {
+
+/** true всередині обчислення під час компіляції (до C++20 - завжди false) */
+SP_CONSTEXPR inline bool isConstantEvaluated() {
+#if SP_CONSTEXPR_ENABLED
+    return __builtin_is_constant_evaluated();
+#else
+    return false;
+#endif
+}
+
+/** sqrt методом Ньютона (для обчислень під час компіляції) */
+SP_CONSTEXPR inline double cxSqrt(double x) {
+    if (!(x > 0.0)) return 0.0;
+    double g = (x > 1.0) ? x : 1.0;
+    for (int i = 0; i < 200; i++) {
+        double next = 0.5 * (g + x / g);
+        if (!(next < g)) break;     // Збіжність зверху - монотонно спадає до кореня
+        g = next;
+    }
+    return g;
+}
+
+/** cos для довільного x: редукція до [0, pi/2] і ряд Тейлора до x^22 */
+SP_CONSTEXPR inline double cxCos(double x) {
+    const double kTwoPi = 6.283185307179586;
+    const double kPi = 3.141592653589793;
+    double k = (double)(int64_t)(x / kTwoPi);
+    x -= k * kTwoPi;
+    if (x < 0.0) x += kTwoPi;
+    if (x > kPi) x = kTwoPi - x;
+    double sign = 1.0;
+    if (x > 0.5 * kPi) {
+        x = kPi - x;
+        sign = -1.0;
+    }
+    double x2 = x * x, term = 1.0, sum = 1.0;
+    for (int n = 2; n <= 22; n += 2) {
+        term = -term * x2 / (double)((n - 1) * n);
+        sum += term;
+    }
+    return sign * sum;
+}
+
+SP_CONSTEXPR inline double cxSin(double x) { return cxCos(1.5707963267948966 - x); }
+
+/** sqrtf / cosf / sinf, придатні для обчислення під час компіляції */
+SP_CONSTEXPR inline float mathSqrt(float x) {
+    return isConstantEvaluated() ? (float)cxSqrt(x) : sqrtf(x);
+}
+
+SP_CONSTEXPR inline float mathCos(float x) {
+    return isConstantEvaluated() ? (float)cxCos(x) : cosf(x);
+}
+
+SP_CONSTEXPR inline float mathSin(float x) {
+    return isConstantEvaluated() ? (float)cxSin(x) : sinf(x);
+}
+
+SP_CONSTEXPR inline double mathSqrt(double x) {
+    return isConstantEvaluated() ? cxSqrt(x) : sqrt(x);
+}
+
+SP_CONSTEXPR inline float mathFloor(float x) {
+    if (!isConstantEvaluated()) return floorf(x);
+    float t = (float)(int64_t)x;
+    return (t > x) ? t - 1.0f : t;
+}
+
+/** x^n для цілого n (під час компіляції - піднесенням до квадрата) */
+SP_CONSTEXPR inline float mathPow(float x, uint32_t n) {
+    if (!isConstantEvaluated()) return powf(x, (float)n);
+    double r = 1.0, b = x;
+    for (; n > 0; n >>= 1) {
+        if (n & 1) r *= b;
+        b *= b;
+    }
+    return (float)r;
+}
+
+/** memcpy / memmove по n значень (під час компіляції - поелементно) */
+template<typename T>
+SP_CONSTEXPR inline void copyValues(T* dst, const T* src, size_t n) {
+    if (!isConstantEvaluated()) {
+        memcpy(dst, src, n * sizeof(T));
+        return;
+    }
+    for (size_t i = 0; i < n; i++) dst[i] = src[i];
+}
+
+template<typename T>
+SP_CONSTEXPR inline void moveValues(T* dst, const T* src, size_t n) {
+    if (!isConstantEvaluated()) {
+        memmove(dst, src, n * sizeof(T));
+        return;
+    }
+    if (dst < src) {
+        for (size_t i = 0; i < n; i++) dst[i] = src[i];
+    } else {
+        for (size_t i = n; i > 0; i--) dst[i - 1] = src[i - 1];
+    }
+}
+
+} // namespace sp_detail
+
+/**
+ * @brief Набір стадій процесора (третій шаблонний параметр)
+ *
+ * Вимкнені стадії не компілюються в add() і не займають пам'яті в об'єкті.
+ * Прапорці комбінуються через `|`, наприклад:
+ *   SignalProcessor<int16_t, 64, SignalFeatures::Mean | SignalFeatures::MinMax>
+ *   SignalProcessor<int16_t, 4096, SignalFeatures::Default | SignalFeatures::MinMaxWedge>
+ */
+struct SignalFeatures {
+    enum Flags {
+        Mean        = 1u << 0,  // Сума: getSum(), getMean(), getSma()
+        Variance    = 1u << 1,  // Сума квадратів: getVariance(), getStdDev(), CV, isOutlier(), isStable() (вмикає Mean)
+        MinMax      = 1u << 2,  // getMin(), getMax(), getRange()
+        Ema         = 1u << 3,  // getEma()
+        Derivative  = 1u << 4,  // getDerivative(), getDerivativeFiltered()
+        Integral    = 1u << 5,  // getIntegral()
+        Lowpass     = 1u << 6,  // IIR-фільтр (каскад біквадів DF2T): getLowpass()
+        SlidingDft  = 1u << 7,  // Ковзний DFT по K бінах: getDftMagnitude(), getDftPhase()
+
+        MinMaxWedge = 1u << 8,  // Min/max через монотонні деки: O(1) амортизовано (вмикає MinMax)
+        StatsCache  = 1u << 9,  // getStats() повертає кешований знімок до наступного add()
+        Median      = 1u << 10, // Впорядковане вікно: getMedian(), getPercentile(), getMAD(), isOutlierMAD()
+        FixedPoint  = 1u << 11, // EMA, похідна, інтегратор у Q15 для цілих T: add() без float-операцій
+        Triggers    = 1u << 15, // Порогові тригери з гістерезисом і callback-ами: addTrigger()
+        Instrumentation = 1u << 23, // Лічильники гарячого шляху і тактів на виклик: getCounters()
+        ExternalBuffer = 1u << 24,  // Буфер вікна - пам'ять користувача (кільце DMA, DTCM/CCM): commitSamples()
+
+        // Кількість біквад-секцій Lowpass (біти 12-14, вмикають Lowpass). Без них - 1 секція
+        LowpassSections2 = (2u << 12) | Lowpass,  // 4-й порядок
+        LowpassSections3 = (3u << 12) | Lowpass,  // 6-й порядок
+        LowpassSections4 = (4u << 12) | Lowpass,  // 8-й порядок
+        LowpassSectionsMask = 7u << 12,
+
+        // Кількість бінів SlidingDft (біти 16-19): slidingDftBins(k). Без них - 1 бін
+        SlidingDftBinsMask = 15u << 16,
+
+        // Кількість слотів Triggers (біти 20-22): triggers(k). Без них - 1 слот
+        TriggersMask = 7u << 20,
+
+        Default     = Mean | Variance | MinMax | Ema | Derivative | Integral | Lowpass,
+
+        // Усі стадії, що мають цілочисельну реалізацію (для МК без FPU, з ExactAccumulator)
+        FixedDefault = Mean | Variance | MinMax | Ema | Derivative | Integral | FixedPoint
+    };
+
+    /** SlidingDft з k бінами (1 - 15), наприклад Default | slidingDftBins(4) */
+    static constexpr uint32_t slidingDftBins(uint32_t k) {
+        return SlidingDft | ((k & 15u) << 16);
+    }
+
+    /** Triggers з k слотами (1 - 7), наприклад Default | triggers(3) */
+    static constexpr uint32_t triggers(uint32_t k) {
+        return Triggers | ((k & 7u) << 20);
+    }
+};
+
+// ========================================
+// IIR-ФІЛЬТРИ (біквади)
+// ========================================
+
+/**
+ * Коефіцієнти однієї біквад-секції (a0 нормовано до 1):
+ *   H(z) = (b0 + b1*z^-1 + b2*z^-2) / (1 + a1*z^-1 + a2*z^-2)
+ * Формули ФНЧ/ФВЧ/смугового - Audio EQ Cookbook (R. Bristow-Johnson)
+ */
+struct BiquadCoeffs {
+    float b0, b1, b2;
+    float a1, a2;
+
+    /** Секція, що пропускає сигнал без змін */
+    static SP_CONSTEXPR BiquadCoeffs identity() {
+        BiquadCoeffs c = { 1.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+        return c;
+    }
+
+    /** Low-pass першого порядку: y += alpha * (x - y) */
+    static SP_CONSTEXPR BiquadCoeffs firstOrderLowpass(float alpha) {
+        BiquadCoeffs c = { alpha, 0.0f, 0.0f, alpha - 1.0f, 0.0f };
+        return c;
+    }
+
+    /**
+     * ФНЧ другого порядку
+     * @param fc Частота зрізу, Гц
+     * @param fs Частота дискретизації, Гц
+     * @param q Добротність (0.7071 - Баттерворт)
+     */
+    static SP_CONSTEXPR BiquadCoeffs lowpass(float fc, float fs, float q = 0.70710678f) {
+        float w0 = 6.28318531f * fc / fs;
+        float cw = sp_detail::mathCos(w0);
+        float alpha = sp_detail::mathSin(w0) / (2.0f * q);
+        float k = 1.0f / (1.0f + alpha);
+        BiquadCoeffs c = { 0.5f * (1.0f - cw) * k, (1.0f - cw) * k, 0.5f * (1.0f - cw) * k,
+                           -2.0f * cw * k, (1.0f - alpha) * k };
+        return c;
+    }
+
+    /** ФВЧ другого порядку (параметри як у lowpass()) */
+    static SP_CONSTEXPR BiquadCoeffs highpass(float fc, float fs, float q = 0.70710678f) {
+        float w0 = 6.28318531f * fc / fs;
+        float cw = sp_detail::mathCos(w0);
+        float alpha = sp_detail::mathSin(w0) / (2.0f * q);
+        float k = 1.0f / (1.0f + alpha);
+        BiquadCoeffs c = { 0.5f * (1.0f + cw) * k, -(1.0f + cw) * k, 0.5f * (1.0f + cw) * k,
+                           -2.0f * cw * k, (1.0f - alpha) * k };
+        return c;
+    }
+
+    /**
+     * Смуговий другого порядку з підсиленням 1 на центральній частоті
+     * @param f0 Центральна частота, Гц
+     * @param q Добротність (f0 / ширина смуги)
+     */
+    static SP_CONSTEXPR BiquadCoeffs bandpass(float f0, float fs, float q) {
+        float w0 = 6.28318531f * f0 / fs;
+        float cw = sp_detail::mathCos(w0);
+        float alpha = sp_detail::mathSin(w0) / (2.0f * q);
+        float k = 1.0f / (1.0f + alpha);
+        BiquadCoeffs c = { alpha * k, 0.0f, -alpha * k, -2.0f * cw * k, (1.0f - alpha) * k };
+        return c;
+    }
+
+    /** Підсилення на постійному струмі (0 для ФВЧ/смугового) */
+    SP_CONSTEXPR float dcGain() const {
+        float den = 1.0f + a1 + a2;
+        return (den != 0.0f) ? (b0 + b1 + b2) / den : 0.0f;
+    }
+};
+
+/**
+ * Коефіцієнти каскадів Баттерворта: sections біквадів = фільтр порядку 2 * sections
+ */
+struct Butterworth {
+    /** Добротність k-ї секції каскаду */
+    static SP_CONSTEXPR float sectionQ(uint8_t k, uint8_t sections) {
+        return 1.0f / (2.0f * sp_detail::mathCos(3.14159265f * (float)(2 * k + 1) / (float)(4 * sections)));
+    }
+
+    /** ФНЧ порядку 2 * sections, fc - частота зрізу (-3 дБ) */
+    static SP_CONSTEXPR void lowpass(BiquadCoeffs* out, uint8_t sections, float fc, float fs) {
+        for (uint8_t k = 0; k < sections; k++) {
+            out[k] = BiquadCoeffs::lowpass(fc, fs, sectionQ(k, sections));
+        }
+    }
+
+    /** ФВЧ порядку 2 * sections */
+    static SP_CONSTEXPR void highpass(BiquadCoeffs* out, uint8_t sections, float fc, float fs) {
+        for (uint8_t k = 0; k < sections; k++) {
+            out[k] = BiquadCoeffs::highpass(fc, fs, sectionQ(k, sections));
+        }
+    }
+
+    /**
+     * Смуговий фільтр [fLow, fHigh]: sections / 2 секцій ФВЧ на fLow + решта ФНЧ на fHigh
+     * Для однієї секції - біквад із центром sqrt(fLow * fHigh) і Q = f0 / (fHigh - fLow)
+     */
+    static SP_CONSTEXPR void bandpass(BiquadCoeffs* out, uint8_t sections, float fLow, float fHigh, float fs) {
+        if (sections == 1) {
+            float f0 = sp_detail::mathSqrt(fLow * fHigh);
+            out[0] = BiquadCoeffs::bandpass(f0, fs, f0 / (fHigh - fLow));
+            return;
+        }
+        uint8_t hp = sections / 2;
+        highpass(out, hp, fLow, fs);
+        lowpass(out + hp, (uint8_t)(sections - hp), fHigh, fs);
+    }
+};
+
+// ========================================
+// СПЕКТР (computeSpectrum)
+// ========================================
+
+/** Вікно перед FFT (таблиця генерується під час компіляції) */
+struct SpectrumWindow {
+    enum Type {
+        Rectangular = 0,    // Без вікна
+        Hann        = 1,    // 0.5 - 0.5 cos - типовий вибір
+        Hamming     = 2,    // 0.54 - 0.46 cos - нижчий перший бічний пелюсток
+        Blackman    = 3     // Найменше розтікання, ширший головний пелюсток
+    };
+};
+
+/** Що computeSpectrum() записує у вихідний масив */
+struct SpectrumOutput {
+    enum Type {
+        Complex   = 0,      // Упаковано: [0] = X[0], [1] = X[N/2], [2k], [2k+1] = Re/Im X[k]
+        Magnitude = 1,      // N/2 + 1 амплітуд синусоїд (з поправкою на підсилення вікна)
+        Power     = 2,      // N/2 + 1 значень потужності в біні (сума = середній квадрат сигналу)
+        Psd       = 3       // N/2 + 1 значень спектральної густини потужності, од.^2 / Гц
+    };
+};
+
+// ========================================
+// ТРИГЕРИ (SignalFeatures::Triggers)
+// ========================================
+
+/**
+ * Пороговий тригер: величина, умова і callback на зміну стану
+ * Стан стає активним, коли умова виконується holdSamples значень поспіль,
+ * і неактивним, коли величина повертається за поріг з гістерезисом.
+ */
+struct SignalTrigger {
+    enum Metric {
+        Value              = 0, // Останнє додане значення
+        Mean               = 1, // Середнє вікна (sum порівнюється з threshold * count)
+        StdDev             = 2, // Стандартне відхилення (дисперсія порівнюється з threshold^2, без sqrt)
+        Ema                = 3, // getEma()
+        Lowpass            = 4, // getLowpass()
+        Derivative         = 5, // getDerivative()
+        DerivativeFiltered = 6  // getDerivativeFiltered()
+    };
+
+    enum Condition {
+        Above = 0,          // Активний: metric > threshold, скидання: metric < threshold - hysteresis
+        Below = 1           // Активний: metric < threshold, скидання: metric > threshold + hysteresis
+    };
+
+    /**
+     * Callback на зміну стану (викликається з контексту add()/addBlock())
+     * @param context Вказівник, переданий в addTrigger()
+     * @param id Номер тригера
+     * @param active Новий стан
+     */
+    typedef void (*Callback)(void* context, uint8_t id, bool active);
+};
+
+// ========================================
+// ІНСТРУМЕНТАЦІЯ (SignalFeatures::Instrumentation)
+// ========================================
+
+/** Такти на виклик: min / max / середнє за clock-функцією користувача */
+struct SignalCycleStats {
+    uint32_t calls;         // Виміряних викликів
+    uint32_t min;           // Мінімум тактів
+    uint32_t max;           // Максимум тактів
+    uint64_t total;         // Сума тактів
+
+    void reset() {
+        calls = 0;
+        min = 0xFFFFFFFFu;
+        max = 0;
+        total = 0;
+    }
+
+    void record(uint32_t cycles) {
+        calls++;
+        if (cycles < min) min = cycles;
+        if (cycles > max) max = cycles;
+        total += cycles;
+    }
+
+    float average() const { return (calls > 0) ? (float)((double)total / (double)calls) : 0.0f; }
+};
+
+/**
+ * Лічильники гарячого шляху (getCounters())
+ * POD без вказівників - можна передавати в телеметрію як є (memcpy).
+ * reset() процесора лічильники не скидає (resetCounters()).
+ */
+struct SignalCounters {
+    /** Clock-функція користувача, наприклад читання DWT->CYCCNT або таймера */
+    typedef uint32_t (*Clock)();
+
+    uint64_t samples;           // Прийнято значень (add() і addBlock())
+    uint32_t minMaxRescans;     // Повних перерахунків min/max після витіснення екстремуму
+    uint64_t minMaxScanned;     // Переглянуто елементів під час цих перерахунків
+    uint32_t derivativeSkipped; // Кроків похідної/інтегратора, пропущених через setDerivativePeriodMs()
+    SignalCycleStats addCycles;      // Такти на add() (тільки з setInstrumentationClock())
+    SignalCycleStats addBlockCycles; // Такти на addBlock()
+
+    void reset() {
+        samples = 0;
+        minMaxRescans = 0;
+        minMaxScanned = 0;
+        derivativeSkipped = 0;
+        addCycles.reset();
+        addBlockCycles.reset();
+    }
+};
+
+// ========================================
+// ОБЧИСЛЮВАЛЬНІ ЯДРА (SIMD / скалярні)
+// ========================================
+//
+// Вибір набору інструкцій - під час компіляції за макросами цілі:
+//   Helium (MVE)  - Cortex-M55/M85 (__ARM_FEATURE_MVE, float - лише з MVE-F)
+//   NEON          - Cortex-A (__ARM_NEON)
+//   AVX2 / SSE2   - x86 (__AVX2__ / __SSE2__)
+// Векторні ядра є для float, int16_t та uint16_t, решта типів - скалярний код.
+// Визначте SIGNAL_PROCESSOR_FORCE_SCALAR перед підключенням, щоб примусово
+// використовувати скалярний шлях (наприклад, для A/B порівняння).
+//
+// SIGNAL_PROCESSOR_SIMD: 0 - скалярний, 1 - SSE2, 2 - AVX2, 3 - NEON, 4 - Helium
+
+#if !defined(SIGNAL_PROCESSOR_FORCE_SCALAR) && defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1)
+#include <arm_mve.h>
+#define SIGNAL_PROCESSOR_SIMD 4
+#elif !defined(SIGNAL_PROCESSOR_FORCE_SCALAR) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#include <arm_neon.h>
+#define SIGNAL_PROCESSOR_SIMD 3
+#elif !defined(SIGNAL_PROCESSOR_FORCE_SCALAR) && defined(__AVX2__)
+#include <immintrin.h>
+#define SIGNAL_PROCESSOR_SIMD 2
+#elif !defined(SIGNAL_PROCESSOR_FORCE_SCALAR) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define SIGNAL_PROCESSOR_SIMD 1
+#else
+#define SIGNAL_PROCESSOR_SIMD 0
+#endif
+
+namespace sp_detail {
+
+/** Ознака цілого типу (без залежності від <type_traits>) */
+template<typename T> struct IsIntegral { static const bool value = false; };
+template<> struct IsIntegral<int8_t> { static const bool value = true; };
+template<> struct IsIntegral<uint8_t> { static const bool value = true; };
+template<> struct IsIntegral<int16_t> { static const bool value = true; };
+template<> struct IsIntegral<uint16_t> { static const bool value = true; };
+template<> struct IsIntegral<int32_t> { static const bool value = true; };
+template<> struct IsIntegral<uint32_t> { static const bool value = true; };
+template<> struct IsIntegral<int64_t> { static const bool value = true; };
+template<> struct IsIntegral<uint64_t> { static const bool value = true; };
+
+/**
+ * Тип для сум у ядрах: 16-бітні та менші цілі сумуються точно в int64_t,
+ * 32/64-бітні цілі - у double (квадрати не вміщаються в int64_t)
+ */
+template<typename T> struct SumTraits { typedef int64_t type; };
+template<> struct SumTraits<float> { typedef float type; };
+template<> struct SumTraits<double> { typedef double type; };
+template<> struct SumTraits<int32_t> { typedef double type; };
+template<> struct SumTraits<uint32_t> { typedef double type; };
+template<> struct SumTraits<int64_t> { typedef double type; };
+template<> struct SumTraits<uint64_t> { typedef double type; };
+
+/** Скалярні ядра - еталон і fallback для всіх типів */
+template<typename T>
+struct ScalarKernel {
+    typedef typename SumTraits<T>::type Sum;
+
+    /** Min/max суцільного непорожнього блоку */
+    static SP_CONSTEXPR void minMax(const T* p, uint32_t n, T& minOut, T& maxOut) {
+        T lo = p[0];
+        T hi = p[0];
+        for (uint32_t i = 1; i < n; i++) {
+            lo = (p[i] < lo) ? p[i] : lo;
+            hi = (p[i] > hi) ? p[i] : hi;
+        }
+        minOut = lo;
+        maxOut = hi;
+    }
+
+    /**
+     * Сума та сума квадратів суцільного блоку
+     * Окремі акумулятори без залежностей між ітераціями - цикл придатний для автовекторизації
+     */
+    static SP_CONSTEXPR void sums(const T* p, uint32_t n, Sum& sumOut, Sum& sumSqOut) {
+        Sum s = 0;
+        Sum sq = 0;
+        for (uint32_t i = 0; i < n; i++) {
+            Sum v = (Sum)p[i];
+            s += v;
+            sq += v * v;
+        }
+        sumOut = s;
+        sumSqOut = sq;
+    }
+};
+
+template<typename T>
+struct Kernel : ScalarKernel<T> {};
+
+#if SIGNAL_PROCESSOR_SIMD != 0
+
+/**
+ * Ядра для 16-бітних цілих
+ * uint16_t зводиться до int16_t зсувом на 0x8000 (x = x' + 32768), тому для обох
+ * типів використовуються знакові інструкції, а суми коригуються в кінці:
+ *   sum   = sum' + 32768 * n
+ *   sumSq = sumSq' + 65536 * sum' + 2^30 * n
+ */
+template<typename T, bool Unsigned>
+struct Kernel16 {
+    typedef int64_t Sum;
+
+    // Кількість векторних ітерацій, після якої 32-бітні часткові суми скидаються в int64
+    static const uint32_t kFlushIters = 16384;
+
+    static T fromBiased(int16_t v) {
+        return Unsigned ? (T)(uint16_t)((uint16_t)v ^ 0x8000u) : (T)v;
+    }
+
+    static void finishSums(const T* p, uint32_t n, uint32_t done,
+                           int64_t s, int64_t sq, Sum& sumOut, Sum& sumSqOut) {
+        if (Unsigned) {
+            sq += 65536 * s + ((int64_t)1 << 30) * (int64_t)done;
+            s += 32768 * (int64_t)done;
+        }
+        for (uint32_t i = done; i < n; i++) {
+            int64_t v = p[i];
+            s += v;
+            sq += v * v;
+        }
+        sumOut = s;
+        sumSqOut = sq;
+    }
+
+#if SIGNAL_PROCESSOR_SIMD == 1 || SIGNAL_PROCESSOR_SIMD == 2
+#if SIGNAL_PROCESSOR_SIMD == 2
+    static const uint32_t kLanes = 16;
+    typedef __m256i Vec;
+    static Vec load(const T* p) { return _mm256_loadu_si256((const __m256i*)p); }
+    static Vec splat(int16_t v) { return _mm256_set1_epi16(v); }
+    static Vec vxor(Vec a, Vec b) { return _mm256_xor_si256(a, b); }
+    static Vec vmin(Vec a, Vec b) { return _mm256_min_epi16(a, b); }
+    static Vec vmax(Vec a, Vec b) { return _mm256_max_epi16(a, b); }
+    static Vec vmadd(Vec a, Vec b) { return _mm256_madd_epi16(a, b); }
+    static Vec add32(Vec a, Vec b) { return _mm256_add_epi32(a, b); }
+    static Vec add64(Vec a, Vec b) { return _mm256_add_epi64(a, b); }
+    static Vec unpackLo32(Vec a, Vec b) { return _mm256_unpacklo_epi32(a, b); }
+    static Vec unpackHi32(Vec a, Vec b) { return _mm256_unpackhi_epi32(a, b); }
+    static Vec zero() { return _mm256_setzero_si256(); }
+    static void store(void* dst, Vec v) { _mm256_storeu_si256((__m256i*)dst, v); }
+#else
+    static const uint32_t kLanes = 8;
+    typedef __m128i Vec;
+    static Vec load(const T* p) { return _mm_loadu_si128((const __m128i*)p); }
+    static Vec splat(int16_t v) { return _mm_set1_epi16(v); }
+    static Vec vxor(Vec a, Vec b) { return _mm_xor_si128(a, b); }
+    static Vec vmin(Vec a, Vec b) { return _mm_min_epi16(a, b); }
+    static Vec vmax(Vec a, Vec b) { return _mm_max_epi16(a, b); }
+    static Vec vmadd(Vec a, Vec b) { return _mm_madd_epi16(a, b); }
+    static Vec add32(Vec a, Vec b) { return _mm_add_epi32(a, b); }
+    static Vec add64(Vec a, Vec b) { return _mm_add_epi64(a, b); }
+    static Vec unpackLo32(Vec a, Vec b) { return _mm_unpacklo_epi32(a, b); }
+    static Vec unpackHi32(Vec a, Vec b) { return _mm_unpackhi_epi32(a, b); }
+    static Vec zero() { return _mm_setzero_si128(); }
+    static void store(void* dst, Vec v) { _mm_storeu_si128((__m128i*)dst, v); }
+#endif
+
+    static void minMax(const T* p, uint32_t n, T& minOut, T& maxOut) {
+        if (n < kLanes) { ScalarKernel<T>::minMax(p, n, minOut, maxOut); return; }
+        const Vec bias = splat(Unsigned ? (int16_t)-32768 : (int16_t)0);
+        Vec lo = vxor(load(p), bias);
+        Vec hi = lo;
+        uint32_t i = kLanes;
+        for (; i + kLanes <= n; i += kLanes) {
+            Vec v = vxor(load(p + i), bias);
+            lo = vmin(lo, v);
+            hi = vmax(hi, v);
+        }
+        int16_t los[kLanes], his[kLanes];
+        store(los, lo);
+        store(his, hi);
+        int16_t l = los[0], h = his[0];
+        for (uint32_t k = 1; k < kLanes; k++) {
+            if (los[k] < l) l = los[k];
+            if (his[k] > h) h = his[k];
+        }
+        T rl = fromBiased(l), rh = fromBiased(h);
+        for (; i < n; i++) {
+            if (p[i] < rl) rl = p[i];
+            if (p[i] > rh) rh = p[i];
+        }
+        minOut = rl;
+        maxOut = rh;
+    }
+
+    static void sums(const T* p, uint32_t n, Sum& sumOut, Sum& sumSqOut) {
+        const Vec bias = splat(Unsigned ? (int16_t)-32768 : (int16_t)0);
+        const Vec ones = splat(1);
+        const Vec z = zero();
+        int64_t s = 0;
+        Vec sq64 = z;
+        uint32_t i = 0;
+        while (i + kLanes <= n) {
+            Vec s32 = z;
+            for (uint32_t it = 0; it < kFlushIters && i + kLanes <= n; it++, i += kLanes) {
+                Vec v = vxor(load(p + i), bias);
+                s32 = add32(s32, vmadd(v, ones));
+                // Пара квадратів <= 2^31 - точна як беззнакове 32-бітне, розширюємо нулями
+                Vec q = vmadd(v, v);
+                sq64 = add64(sq64, unpackLo32(q, z));
+                sq64 = add64(sq64, unpackHi32(q, z));
+            }
+            int32_t parts[kLanes / 2];
+            store(parts, s32);
+            for (uint32_t k = 0; k < kLanes / 2; k++) s += parts[k];
+        }
+        int64_t sqParts[kLanes / 4];
+        store(sqParts, sq64);
+        int64_t sq = 0;
+        for (uint32_t k = 0; k < kLanes / 4; k++) sq += sqParts[k];
+        finishSums(p, n, i, s, sq, sumOut, sumSqOut);
+    }
+
+#elif SIGNAL_PROCESSOR_SIMD == 3
+    static const uint32_t kLanes = 8;
+
+    static int16x8_t load(const T* p) {
+        int16x8_t v = vreinterpretq_s16_u16(vld1q_u16((const uint16_t*)p));
+        return Unsigned ? veorq_s16(v, vdupq_n_s16((int16_t)-32768)) : v;
+    }
+
+    static void minMax(const T* p, uint32_t n, T& minOut, T& maxOut) {
+        if (n < kLanes) { ScalarKernel<T>::minMax(p, n, minOut, maxOut); return; }
+        int16x8_t lo = load(p);
+        int16x8_t hi = lo;
+        uint32_t i = kLanes;
+        for (; i + kLanes <= n; i += kLanes) {
+            int16x8_t v = load(p + i);
+            lo = vminq_s16(lo, v);
+            hi = vmaxq_s16(hi, v);
+        }
+        int16_t los[kLanes], his[kLanes];
+        vst1q_s16(los, lo);
+        vst1q_s16(his, hi);
+        int16_t l = los[0], h = his[0];
+        for (uint32_t k = 1; k < kLanes; k++) {
+            if (los[k] < l) l = los[k];
+            if (his[k] > h) h = his[k];
+        }
+        T rl = fromBiased(l), rh = fromBiased(h);
+        for (; i < n; i++) {
+            if (p[i] < rl) rl = p[i];
+            if (p[i] > rh) rh = p[i];
+        }
+        minOut = rl;
+        maxOut = rh;
+    }
+
+    static void sums(const T* p, uint32_t n, Sum& sumOut, Sum& sumSqOut) {
+        int64_t s = 0;
+        uint64x2_t sq64 = vdupq_n_u64(0);
+        uint32_t i = 0;
+        while (i + kLanes <= n) {
+            int32x4_t s32 = vdupq_n_s32(0);
+            for (uint32_t it = 0; it < kFlushIters && i + kLanes <= n; it++, i += kLanes) {
+                int16x8_t v = load(p + i);
+                s32 = vpadalq_s16(s32, v);
+                int32x4_t qLo = vmull_s16(vget_low_s16(v), vget_low_s16(v));
+                int32x4_t qHi = vmull_s16(vget_high_s16(v), vget_high_s16(v));
+                sq64 = vpadalq_u32(sq64, vreinterpretq_u32_s32(qLo));
+                sq64 = vpadalq_u32(sq64, vreinterpretq_u32_s32(qHi));
+            }
+            int32_t parts[4];
+            vst1q_s32(parts, s32);
+            s += (int64_t)parts[0] + parts[1] + parts[2] + parts[3];
+        }
+        uint64_t sqParts[2];
+        vst1q_u64(sqParts, sq64);
+        finishSums(p, n, i, s, (int64_t)(sqParts[0] + sqParts[1]), sumOut, sumSqOut);
+    }
+
+#elif SIGNAL_PROCESSOR_SIMD == 4
+    static const uint32_t kLanes = 8;
+
+    static int16x8_t load(const T* p) {
+        int16x8_t v = vreinterpretq_s16_u16(vldrhq_u16((const uint16_t*)p));
+        return Unsigned ? veorq_s16(v, vdupq_n_s16((int16_t)-32768)) : v;
+    }
+
+    static void minMax(const T* p, uint32_t n, T& minOut, T& maxOut) {
+        if (n < kLanes) { ScalarKernel<T>::minMax(p, n, minOut, maxOut); return; }
+        int16_t l = INT16_MAX, h = INT16_MIN;
+        uint32_t i = 0;
+        for (; i + kLanes <= n; i += kLanes) {
+            int16x8_t v = load(p + i);
+            l = vminvq_s16(l, v);
+            h = vmaxvq_s16(h, v);
+        }
+        T rl = fromBiased(l), rh = fromBiased(h);
+        for (; i < n; i++) {
+            if (p[i] < rl) rl = p[i];
+            if (p[i] > rh) rh = p[i];
+        }
+        minOut = rl;
+        maxOut = rh;
+    }
+
+    static void sums(const T* p, uint32_t n, Sum& sumOut, Sum& sumSqOut) {
+        int64_t s = 0;
+        int64_t sq = 0;
+        uint32_t i = 0;
+        while (i + kLanes <= n) {
+            int32_t s32 = 0;
+            for (uint32_t it = 0; it < kFlushIters && i + kLanes <= n; it++, i += kLanes) {
+                int16x8_t v = load(p + i);
+                s32 = vaddvaq_s16(s32, v);
+                sq = vmlaldavaq_s16(sq, v, v);
+            }
+            s += s32;
+        }
+        finishSums(p, n, i, s, sq, sumOut, sumSqOut);
+    }
+#endif
+};
+
+template<> struct Kernel<int16_t> : Kernel16<int16_t, false> {};
+template<> struct Kernel<uint16_t> : Kernel16<uint16_t, true> {};
+
+#if SIGNAL_PROCESSOR_SIMD != 4 || (__ARM_FEATURE_MVE & 2)
+/** Ядра для float (часткові суми по лініях - порядок додавання відрізняється від скалярного) */
+template<>
+struct Kernel<float> {
+    typedef float Sum;
+
+#if SIGNAL_PROCESSOR_SIMD == 2
+    static const uint32_t kLanes = 8;
+    typedef __m256 Vec;
+    static Vec load(const float* p) { return _mm256_loadu_ps(p); }
+    static Vec zero() { return _mm256_setzero_ps(); }
+    static Vec vmin(Vec a, Vec b) { return _mm256_min_ps(a, b); }
+    static Vec vmax(Vec a, Vec b) { return _mm256_max_ps(a, b); }
+    static Vec vadd(Vec a, Vec b) { return _mm256_add_ps(a, b); }
+    static Vec vmla(Vec acc, Vec a) { return _mm256_add_ps(acc, _mm256_mul_ps(a, a)); }
+    static void store(float* dst, Vec v) { _mm256_storeu_ps(dst, v); }
+#elif SIGNAL_PROCESSOR_SIMD == 1
+    static const uint32_t kLanes = 4;
+    typedef __m128 Vec;
+    static Vec load(const float* p) { return _mm_loadu_ps(p); }
+    static Vec zero() { return _mm_setzero_ps(); }
+    static Vec vmin(Vec a, Vec b) { return _mm_min_ps(a, b); }
+    static Vec vmax(Vec a, Vec b) { return _mm_max_ps(a, b); }
+    static Vec vadd(Vec a, Vec b) { return _mm_add_ps(a, b); }
+    static Vec vmla(Vec acc, Vec a) { return _mm_add_ps(acc, _mm_mul_ps(a, a)); }
+    static void store(float* dst, Vec v) { _mm_storeu_ps(dst, v); }
+#elif SIGNAL_PROCESSOR_SIMD == 3
+    static const uint32_t kLanes = 4;
+    typedef float32x4_t Vec;
+    static Vec load(const float* p) { return vld1q_f32(p); }
+    static Vec zero() { return vdupq_n_f32(0.0f); }
+    static Vec vmin(Vec a, Vec b) { return vminq_f32(a, b); }
+    static Vec vmax(Vec a, Vec b) { return vmaxq_f32(a, b); }
+    static Vec vadd(Vec a, Vec b) { return vaddq_f32(a, b); }
+    static Vec vmla(Vec acc, Vec a) { return vmlaq_f32(acc, a, a); }
+    static void store(float* dst, Vec v) { vst1q_f32(dst, v); }
+#else
+    static const uint32_t kLanes = 4;
+    typedef float32x4_t Vec;
+    static Vec load(const float* p) { return vldrwq_f32(p); }
+    static Vec zero() { return vdupq_n_f32(0.0f); }
+    static Vec vmin(Vec a, Vec b) { return vminnmq_f32(a, b); }
+    static Vec vmax(Vec a, Vec b) { return vmaxnmq_f32(a, b); }
+    static Vec vadd(Vec a, Vec b) { return vaddq_f32(a, b); }
+    static Vec vmla(Vec acc, Vec a) { return vfmaq_f32(acc, a, a); }
+    static void store(float* dst, Vec v) { vstrwq_f32(dst, v); }
+#endif
+
+    static void minMax(const float* p, uint32_t n, float& minOut, float& maxOut) {
+        if (n < kLanes) { ScalarKernel<float>::minMax(p, n, minOut, maxOut); return; }
+        Vec lo = load(p);
+        Vec hi = lo;
+        uint32_t i = kLanes;
+        for (; i + kLanes <= n; i += kLanes) {
+            Vec v = load(p + i);
+            lo = vmin(lo, v);
+            hi = vmax(hi, v);
+        }
+        float los[kLanes], his[kLanes];
+        store(los, lo);
+        store(his, hi);
+        float l = los[0], h = his[0];
+        for (uint32_t k = 1; k < kLanes; k++) {
+            if (los[k] < l) l = los[k];
+            if (his[k] > h) h = his[k];
+        }
+        for (; i < n; i++) {
+            if (p[i] < l) l = p[i];
+            if (p[i] > h) h = p[i];
+        }
+        minOut = l;
+        maxOut = h;
+    }
+
+    static void sums(const float* p, uint32_t n, Sum& sumOut, Sum& sumSqOut) {
+        Vec s = zero();
+        Vec sq = zero();
+        uint32_t i = 0;
+        for (; i + kLanes <= n; i += kLanes) {
+            Vec v = load(p + i);
+            s = vadd(s, v);
+            sq = vmla(sq, v);
+        }
+        float ss[kLanes], qs[kLanes];
+        store(ss, s);
+        store(qs, sq);
+        float rs = 0.0f, rq = 0.0f;
+        for (uint32_t k = 0; k < kLanes; k++) {
+            rs += ss[k];
+            rq += qs[k];
+        }
+        for (; i < n; i++) {
+            rs += p[i];
+            rq += p[i] * p[i];
+        }
+        sumOut = rs;
+        sumSqOut = rq;
+    }
+};
+#endif
+
+#endif // SIGNAL_PROCESSOR_SIMD != 0
+
+#if SP_CONSTEXPR_ENABLED
+/** Векторне ядро на виконанні, скалярне - під час компіляції (інтринсики там недоступні) */
+template<typename T>
+struct ConstantKernel {
+    typedef typename Kernel<T>::Sum Sum;
+
+    static constexpr void minMax(const T* p, uint32_t n, T& minOut, T& maxOut) {
+        if (isConstantEvaluated()) ScalarKernel<T>::minMax(p, n, minOut, maxOut);
+        else Kernel<T>::minMax(p, n, minOut, maxOut);
+    }
+
+    static constexpr void sums(const T* p, uint32_t n, Sum& sumOut, Sum& sumSqOut) {
+        if (isConstantEvaluated()) ScalarKernel<T>::sums(p, n, sumOut, sumSqOut);
+        else Kernel<T>::sums(p, n, sumOut, sumSqOut);
+    }
+};
+#endif
+
+/** Ядро для вікна N: коротше за найширший вектор (16 значень) - скалярне */
+template<typename T, bool Wide>
+struct KernelSelect {
+#if SP_CONSTEXPR_ENABLED
+    typedef ConstantKernel<T> type;
+#else
+    typedef Kernel<T> type;
+#endif
+};
+
+template<typename T>
+struct KernelSelect<T, false> { typedef ScalarKernel<T> type; };
+
+/**
+ * Суми для цілого акумулятора (ExactAccumulator) з 32/64-бітними T: ядра рахують їх
+ * у double, і сума квадратів блоку понад 2^53 округлюється. Тут - скалярно в int64_t,
+ * тими самими операціями, що й add(), щоб витіснення по одному значенню було точним
+ */
+template<typename T>
+struct ExactSumKernel {
+    typedef int64_t Sum;
+
+    static SP_CONSTEXPR void sums(const T* p, uint32_t n, Sum& sumOut, Sum& sumSqOut) {
+        Sum s = 0;
+        Sum sq = 0;
+        for (uint32_t i = 0; i < n; i++) {
+            Sum v = (Sum)p[i];
+            s += v;
+            sq += v * v;
+        }
+        sumOut = s;
+        sumSqOut = sq;
+    }
+};
+
+/** Ядро сум вікна: Kernel, або ExactSumKernel, якщо Kernel::Sum неточний для цілого Term */
+template<typename T, class Kernel, typename Term,
+         bool Exact = IsIntegral<Term>::value && !IsIntegral<typename Kernel::Sum>::value>
+struct SumKernelSelect { typedef Kernel type; };
+
+template<typename T, class Kernel, typename Term>
+struct SumKernelSelect<T, Kernel, Term, true> { typedef ExactSumKernel<T> type; };
+
+/** MAC-ядро FIR за типом коефіцієнтів: float або Q15 (int16_t) */
+template<typename Tap> struct FirMac;
+
+template<>
+struct FirMac<float> {
+    typedef float Acc;
+    typedef float Output;
+
+    /** Скалярний добуток x[0..n) * h[0..n) */
+    template<typename T>
+    static float dot(const T* x, const float* h, uint32_t n) {
+        // 8 незалежних часткових сум: компілятор векторизує їх без -ffast-math
+        float acc[8] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+        uint32_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            for (uint32_t j = 0; j < 8; j++) acc[j] += h[i + j] * (float)x[i + j];
+        }
+        float s = ((acc[0] + acc[4]) + (acc[1] + acc[5])) + ((acc[2] + acc[6]) + (acc[3] + acc[7]));
+        for (; i < n; i++) s += h[i] * (float)x[i];
+        return s;
+    }
+
+    static Output output(Acc acc) { return acc; }
+};
+
+template<>
+struct FirMac<int16_t> {
+    typedef int64_t Acc;    // 64-бітний акумулятор, як у CMSIS-DSP arm_fir_q15
+    typedef int16_t Output;
+
+    template<typename T>
+    static int64_t dot(const T* x, const int16_t* h, uint32_t n) {
+        static_assert(IsIntegral<T>::value && sizeof(T) == 2 && (T)-1 < 0, "Q15 FIR needs int16_t samples");
+        int64_t acc[4] = { 0, 0, 0, 0 };
+        uint32_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            for (uint32_t j = 0; j < 4; j++) acc[j] += (int32_t)h[i + j] * (int32_t)x[i + j];
+        }
+        int64_t s = (acc[0] + acc[1]) + (acc[2] + acc[3]);
+        for (; i < n; i++) s += (int32_t)h[i] * (int32_t)x[i];
+        return s;
+    }
+
+    /** Q30 -> Q15 з округленням і насиченням */
+    static Output output(Acc acc) {
+        acc = (acc + (1 << 14)) >> 15;
+        return (acc > 32767) ? (int16_t)32767 : (acc < -32768) ? (int16_t)-32768 : (int16_t)acc;
+    }
+};
+
+/** Min/max по двох суцільних сегментах кільця (сумарно непорожні) */
+template<typename T>
+inline void ringMinMax(const T* a, uint32_t na, const T* b, uint32_t nb, T& minOut, T& maxOut) {
+    if (na == 0) { Kernel<T>::minMax(b, nb, minOut, maxOut); return; }
+    Kernel<T>::minMax(a, na, minOut, maxOut);
+    if (nb == 0) return;
+    T lo, hi;
+    Kernel<T>::minMax(b, nb, lo, hi);
+    if (lo < minOut) minOut = lo;
+    if (hi > maxOut) maxOut = hi;
+}
+
+/** Сума та сума квадратів по двох суцільних сегментах кільця */
+template<typename T>
+inline void ringSums(const T* a, uint32_t na, const T* b, uint32_t nb,
+                     typename Kernel<T>::Sum& sumOut, typename Kernel<T>::Sum& sumSqOut) {
+    typename Kernel<T>::Sum s = 0, sq = 0, s2 = 0, sq2 = 0;
+    if (na > 0) Kernel<T>::sums(a, na, s, sq);
+    if (nb > 0) Kernel<T>::sums(b, nb, s2, sq2);
+    sumOut = s + s2;
+    sumSqOut = sq + sq2;
+}
+
+/** Розмір/індекс буфера: uint16_t до 65535 елементів, далі uint32_t */
+template<bool Small> struct SizeSelect { typedef uint16_t type; };
+template<> struct SizeSelect<false> { typedef uint32_t type; };
+
+/**
+ * Арифметика індексів циклічного буфера розміру N
+ * Для N = 2^k перехід через кінець - маска без розгалуження (kPow2 - константа часу компіляції).
+ * Також політика кільця SignalProcessorCore з ємністю часу компіляції (SignalProcessor);
+ * ємність часу виконання - DynRing (SignalProcessorDyn) з тим самим інтерфейсом
+ */
+template<uint32_t N>
+struct Ring {
+    typedef typename SizeSelect<(N <= 0xFFFFu)>::type Index;
+    static const bool kPow2 = (N & (N - 1)) == 0;
+    static const bool kFixed = true;            // Ємність - константа часу компіляції
+    static const uint32_t kCapacity = N;        // Для стадій, пам'ять яких залежить від N
+
+    static SP_CONSTEXPR uint32_t capacity() { return N; }
+
+    /** (i + k) mod N для i < N, k <= N */
+    static SP_CONSTEXPR Index advance(Index i, uint32_t k) {
+        uint32_t j = (uint32_t)i + k;
+        return kPow2 ? (Index)(j & (N - 1)) : (Index)((j >= N) ? j - N : j);
+    }
+
+    static SP_CONSTEXPR Index next(Index i) { return advance(i, 1); }
+};
+
+/**
+ * Пам'ять вікна: вбудований масив T[N] або вказівник на буфер користувача
+ * (SignalFeatures::ExternalBuffer). Обидва варіанти індексуються однаково
+ */
+template<typename T, uint32_t N, bool External>
+struct BufferStorage {
+    typedef T Type[N];
+};
+
+template<typename T, uint32_t N>
+struct BufferStorage<T, N, true> {
+    typedef T* Type;
+};
+
+/**
+ * Дек індексів фіксованої ємності N поверх циклічного масиву
+ * Використовується для монотонних черг (sliding-window min/max)
+ */
+template<uint32_t N>
+class IndexDeque {
+    typedef typename Ring<N>::Index Index;
+
+    Index data_[N];
+    Index head_;            // Позиція першого елемента
+    Index size_;            // Кількість елементів
+
+public:
+    SP_CONSTEXPR IndexDeque() : head_(0), size_(0) {}
+
+    SP_CONSTEXPR void clear() { head_ = 0; size_ = 0; }
+    SP_CONSTEXPR bool empty() const { return size_ == 0; }
+
+    SP_CONSTEXPR Index front() const { return data_[head_]; }
+    SP_CONSTEXPR Index back() const { return data_[Ring<N>::advance(head_, (uint32_t)size_ - 1)]; }
+
+    SP_CONSTEXPR void pushBack(Index v) { data_[Ring<N>::advance(head_, size_)] = v; size_++; }
+    SP_CONSTEXPR void popBack() { size_--; }
+    SP_CONSTEXPR void popFront() { head_ = Ring<N>::next(head_); size_--; }
+};
+
+/**
+ * Лінивий min/max (типовий режим)
+ * Після видалення екстремуму з вікна - повний перерахунок O(N) при наступному запиті.
+ * Під час компіляції кеш (mutable-поля) не читається: GCC до 13 не допускає читання
+ * mutable у константних виразах, тому кожен запит рахує вікно заново, а оновлення
+ * лише позначають кеш застарілим (запис дозволений) - процесор, заповнений під час
+ * компіляції і скопійований на виконання, перерахує min/max при першому запиті
+ */
+template<typename T, uint32_t N>
+class LazyMinMax {
+    typedef typename Ring<N>::Index Index;
+    typedef typename KernelSelect<T, (N >= 16)>::type MinMaxKernel;
+
+    mutable T minVal_;              // Мінімальне значення
+    mutable T maxVal_;              // Максимальне значення
+    mutable bool needRecalcMinMax_; // Прапорець для ліниво перерахунку min/max
+
+    /**
+     * Перерахунок min/max по всьому буферу
+     * Викликається лінива (lazy), тільки коли потрібно і встановлений прапорець
+     */
+    SP_CONSTEXPR void recalculateMinMax(const T* buffer, Index count) const {
+        if (count == 0) {
+            minVal_ = maxVal_ = 0;
+            needRecalcMinMax_ = false;
+            return;
+        }
+
+        MinMaxKernel::minMax(buffer, count, minVal_, maxVal_);
+        needRecalcMinMax_ = false;
+    }
+
+public:
+    SP_CONSTEXPR LazyMinMax() : minVal_(0), maxVal_(0), needRecalcMinMax_(false) {}
+
+    SP_CONSTEXPR void reset() {
+        minVal_ = maxVal_ = 0;
+        needRecalcMinMax_ = false;
+    }
+
+    /** Значення у позиції pos буде перезаписане */
+    SP_CONSTEXPR void evict(const T* buffer, Index pos) {
+        if (isConstantEvaluated()) { needRecalcMinMax_ = true; return; }
+        // Якщо видаляємо min або max - позначаємо, що потрібен перерахунок
+        T oldValue = buffer[pos];
+        if (oldValue == minVal_ || oldValue == maxVal_) {
+            needRecalcMinMax_ = true;
+        }
+    }
+
+    /** Нове значення вже записане у позицію pos, count - кількість після запису */
+    SP_CONSTEXPR void insert(const T* buffer, Index pos, Index count) {
+        if (isConstantEvaluated()) { needRecalcMinMax_ = true; return; }
+        T value = buffer[pos];
+        // Оновлення min/max (швидке, якщо не потрібен повний перерахунок)
+        if (count == 1) {
+            minVal_ = maxVal_ = value;
+            needRecalcMinMax_ = false;
+        } else if (!needRecalcMinMax_) {
+            if (value < minVal_) minVal_ = value;
+            if (value > maxVal_) maxVal_ = value;
+        }
+    }
+
+    /** Значення у позиціях [pos, pos + len) будуть перезаписані */
+    SP_CONSTEXPR void evictBlock(const T* buffer, Index pos, Index len) {
+        if (isConstantEvaluated()) { needRecalcMinMax_ = true; return; }
+        T lo, hi;
+        MinMaxKernel::minMax(buffer + pos, len, lo, hi);
+        if (!(lo > minVal_) || !(hi < maxVal_)) {
+            needRecalcMinMax_ = true;
+        }
+    }
+
+    /** Блок уже записаний у [pos, pos + len), count - кількість після запису */
+    SP_CONSTEXPR void insertBlock(const T* buffer, Index pos, Index len, Index count) {
+        if (isConstantEvaluated()) { needRecalcMinMax_ = true; return; }
+        T lo, hi;
+        MinMaxKernel::minMax(buffer + pos, len, lo, hi);
+        if (count == len) {
+            // Вікно складається лише з нового блоку
+            minVal_ = lo;
+            maxVal_ = hi;
+            needRecalcMinMax_ = false;
+        } else if (!needRecalcMinMax_) {
+            if (lo < minVal_) minVal_ = lo;
+            if (hi > maxVal_) maxVal_ = hi;
+        }
+    }
+
+    SP_CONSTEXPR T min(const T* buffer, Index count) const {
+        T lo = 0, hi = 0;
+        minMax(buffer, count, lo, hi);
+        return lo;
+    }
+
+    SP_CONSTEXPR T max(const T* buffer, Index count) const {
+        T lo = 0, hi = 0;
+        minMax(buffer, count, lo, hi);
+        return hi;
+    }
+
+    /** min і max з однією перевіркою прапорця */
+    SP_CONSTEXPR void minMax(const T* buffer, Index count, T& lo, T& hi) const {
+        if (isConstantEvaluated()) {
+            lo = hi = 0;
+            if (count > 0) MinMaxKernel::minMax(buffer, count, lo, hi);
+            return;
+        }
+        if (needRecalcMinMax_) recalculateMinMax(buffer, count);
+        lo = minVal_;
+        hi = maxVal_;
+    }
+
+    /** Наступний запит перерахує весь буфер */
+    SP_CONSTEXPR bool minMaxStale() const { return !isConstantEvaluated() && needRecalcMinMax_; }
+};
+
+/**
+ * Min/max через монотонні деки (ascending minima / descending maxima)
+ * Кожна позиція потрапляє в дек і виходить з нього не більше одного разу:
+ * оновлення O(1) амортизовано, запит O(1) без перерахунку
+ */
+template<typename T, uint32_t N>
+class WedgeMinMax {
+    typedef typename Ring<N>::Index Index;
+
+    IndexDeque<N> minQ_;    // Позиції кандидатів на мінімум (значення зростають)
+    IndexDeque<N> maxQ_;    // Позиції кандидатів на максимум (значення спадають)
+
+public:
+    SP_CONSTEXPR void reset() {
+        minQ_.clear();
+        maxQ_.clear();
+    }
+
+    /** Значення у позиції pos буде перезаписане */
+    SP_CONSTEXPR void evict(const T* buffer, Index pos) {
+        (void)buffer;
+        // Найстаріший елемент - завжди перший у деку, якщо він там ще є
+        if (!minQ_.empty() && minQ_.front() == pos) minQ_.popFront();
+        if (!maxQ_.empty() && maxQ_.front() == pos) maxQ_.popFront();
+    }
+
+    /** Нове значення вже записане у позицію pos, count - кількість після запису */
+    SP_CONSTEXPR void insert(const T* buffer, Index pos, Index count) {
+        (void)count;
+        T value = buffer[pos];
+        // Старші елементи, не кращі за нове значення, вже ніколи не стануть екстремумом
+        while (!minQ_.empty() && !(buffer[minQ_.back()] < value)) minQ_.popBack();
+        minQ_.pushBack(pos);
+        while (!maxQ_.empty() && !(buffer[maxQ_.back()] > value)) maxQ_.popBack();
+        maxQ_.pushBack(pos);
+    }
+
+    /** Значення у позиціях [pos, pos + len) будуть перезаписані */
+    SP_CONSTEXPR void evictBlock(const T* buffer, Index pos, Index len) {
+        for (Index i = 0; i < len; i++) evict(buffer, (Index)(pos + i));
+    }
+
+    /** Блок уже записаний у [pos, pos + len), count - кількість після запису */
+    SP_CONSTEXPR void insertBlock(const T* buffer, Index pos, Index len, Index count) {
+        for (Index i = 0; i < len; i++) insert(buffer, (Index)(pos + i), count);
+    }
+
+    SP_CONSTEXPR T min(const T* buffer, Index count) const {
+        return (count == 0) ? T(0) : buffer[minQ_.front()];
+    }
+
+    SP_CONSTEXPR T max(const T* buffer, Index count) const {
+        return (count == 0) ? T(0) : buffer[maxQ_.front()];
+    }
+
+    SP_CONSTEXPR void minMax(const T* buffer, Index count, T& lo, T& hi) const {
+        lo = min(buffer, count);
+        hi = max(buffer, count);
+    }
+
+    SP_CONSTEXPR bool minMaxStale() const { return false; }
+};
+
+/** Min/max вимкнено (SignalFeatures::MinMax відсутній): порожній клас без пам'яті */
+template<typename T, uint32_t N>
+class NoMinMax {
+    typedef typename Ring<N>::Index Index;
+
+public:
+    SP_CONSTEXPR void reset() {}
+    SP_CONSTEXPR void evict(const T*, Index) {}
+    SP_CONSTEXPR void insert(const T*, Index, Index) {}
+    SP_CONSTEXPR void evictBlock(const T*, Index, Index) {}
+    SP_CONSTEXPR void insertBlock(const T*, Index, Index, Index) {}
+    SP_CONSTEXPR void minMax(const T*, Index, T& lo, T& hi) const { lo = hi = 0; }
+    SP_CONSTEXPR bool minMaxStale() const { return false; }
+};
+
+/** Вибір реалізації min/max за прапорцями */
+template<typename T, uint32_t N, bool Enabled, bool Wedge>
+struct MinMaxSelect { typedef NoMinMax<T, N> type; };
+
+template<typename T, uint32_t N>
+struct MinMaxSelect<T, N, true, false> { typedef LazyMinMax<T, N> type; };
+
+template<typename T, uint32_t N>
+struct MinMaxSelect<T, N, true, true> { typedef WedgeMinMax<T, N> type; };
+
+// ========================================
+// СТАДІЇ ОБРОБКИ
+// ========================================
+//
+// Кожна стадія - базовий клас процесора зі спеціалізацією для вимкненого стану.
+// Вимкнена стадія порожня (empty base optimization - 0 байт) і має порожні методи,
+// тому відповідний код повністю зникає з add().
+
+/** Сума значень (SignalFeatures::Mean) */
+template<bool Enabled, typename Acc>
+struct SumStage {
+    Acc sum_;               // Сума всіх значень
+
+    SP_CONSTEXPR void sumReset() { sum_.reset(); }
+    SP_CONSTEXPR void sumAdd(typename Acc::Term x) { sum_.add(x); }
+    SP_CONSTEXPR void sumSub(typename Acc::Term x) { sum_.sub(x); }
+    SP_CONSTEXPR typename Acc::Value sumValue() const { return sum_.value(); }
+};
+
+template<typename Acc>
+struct SumStage<false, Acc> {
+    SP_CONSTEXPR void sumReset() {}
+    SP_CONSTEXPR void sumAdd(typename Acc::Term) {}
+    SP_CONSTEXPR void sumSub(typename Acc::Term) {}
+    SP_CONSTEXPR typename Acc::Value sumValue() const { return 0; }
+};
+
+/** Сума квадратів (SignalFeatures::Variance) */
+template<bool Enabled, typename Acc>
+struct SumSqStage {
+    Acc sumSq_;             // Сума квадратів
+
+    SP_CONSTEXPR void sumSqReset() { sumSq_.reset(); }
+    SP_CONSTEXPR void sumSqAdd(typename Acc::Term x) { sumSq_.add(x); }
+    SP_CONSTEXPR void sumSqSub(typename Acc::Term x) { sumSq_.sub(x); }
+    SP_CONSTEXPR typename Acc::Value sumSqValue() const { return sumSq_.value(); }
+};
+
+template<typename Acc>
+struct SumSqStage<false, Acc> {
+    SP_CONSTEXPR void sumSqReset() {}
+    SP_CONSTEXPR void sumSqAdd(typename Acc::Term) {}
+    SP_CONSTEXPR void sumSqSub(typename Acc::Term) {}
+    SP_CONSTEXPR typename Acc::Value sumSqValue() const { return 0; }
+};
+
+/** Exponential Moving Average (SignalFeatures::Ema) */
+template<bool Enabled>
+struct EmaStage {
+    float ema_;             // Exponential Moving Average
+    float alphaEma_;        // Коефіцієнт EMA (0.0 - 1.0)
+
+    SP_CONSTEXPR EmaStage() : ema_(0.0f), alphaEma_(0.1f) {}
+
+    SP_CONSTEXPR void emaReset() { ema_ = 0.0f; }
+
+    /** first - перше значення у вікні (EMA стартує з нього) */
+    SP_CONSTEXPR void emaUpdate(float value, bool first) {
+        if (first) {
+            ema_ = value;
+        } else {
+            ema_ = alphaEma_ * value + (1.0f - alphaEma_) * ema_;
+        }
+    }
+
+    /** Рекурентність EMA одним проходом по блоку */
+    template<typename T>
+    SP_CONSTEXPR void emaUpdateBlock(const T* samples, size_t n, bool firstIsNew) {
+        size_t i = 0;
+        float ema = ema_;
+        if (firstIsNew) ema = (float)samples[i++];
+        const float a = alphaEma_;
+        const float b = 1.0f - alphaEma_;
+        for (; i < n; i++) {
+            ema = a * (float)samples[i] + b * ema;
+        }
+        ema_ = ema;
+    }
+
+    /** Поточне значення EMA (для похідної по фільтрованому сигналу) */
+    SP_CONSTEXPR float emaOr(float) const { return ema_; }
+
+    SP_CONSTEXPR float emaValue() const { return ema_; }
+    SP_CONSTEXPR void emaSetAlpha(float alpha) { alphaEma_ = alpha; }
+};
+
+template<>
+struct EmaStage<false> {
+    SP_CONSTEXPR void emaReset() {}
+    SP_CONSTEXPR void emaUpdate(float, bool) {}
+    template<typename T>
+    SP_CONSTEXPR void emaUpdateBlock(const T*, size_t, bool) {}
+    SP_CONSTEXPR float emaOr(float fallback) const { return fallback; }
+    SP_CONSTEXPR float emaValue() const { return 0.0f; }
+    SP_CONSTEXPR void emaSetAlpha(float) {}
+};
+
+/**
+ * Інтервал між кроками похідної/інтегратора (обчислюється TimeStage і кешується:
+ * при сталому інтервалі ділення не виконується)
+ * ticks == 0 - перший крок після reset(): стадії тільки запам'ятовують значення
+ */
+template<bool Fixed>
+struct TimeDelta {
+    uint32_t ticks;         // Інтервал у тіках часової бази
+    float halfDt;           // dt / 2, с (трапецоїдальний інтегратор)
+    float invDt;            // 1 / dt, 1/с (похідна)
+
+    SP_CONSTEXPR void assign(uint32_t t, uint32_t ticksPerSecond) {
+        ticks = t;
+        float dt = (float)t / (float)ticksPerSecond;
+        halfDt = 0.5f * dt;
+        invDt = (float)ticksPerSecond / (float)t;
+    }
+};
+
+/** Інтервал для цілочисельних стадій: множник швидкості замість 1/dt */
+template<>
+struct TimeDelta<true> {
+    uint32_t ticks;         // Інтервал у тіках часової бази
+    uint32_t ticksPerSecond;
+    uint32_t rateScale;     // (ticksPerSecond << rateShift) / ticks, < 2^31
+    uint8_t rateShift;      // До 16
+
+    SP_CONSTEXPR void assign(uint32_t t, uint32_t tps) {
+        ticks = t;
+        ticksPerSecond = tps;
+        // Одне 64-бітне ділення на зміну інтервалу; зсув зменшується, поки множник не вміститься
+        uint64_t q = ((uint64_t)tps << 16) / t;
+        uint8_t shift = 16;
+        while (q >= 0x80000000ull && shift > 0) { q >>= 1; shift--; }
+        rateScale = (q >= 0x80000000ull) ? 0x7FFFFFFFu : (uint32_t)q;
+        rateShift = shift;
+    }
+};
+
+/**
+ * Часова база похідної/інтегратора (SignalFeatures::Derivative або Integral)
+ * Мітки - у тіках (типово мс, setTimeBase()), інтервал - беззнакова різниця,
+ * тому перехід uint32_t через нуль обробляється коректно. З setSamplePeriod()
+ * мітки не потрібні: кожне значення - крок фіксованої тривалості.
+ */
+template<bool Enabled, bool Fixed>
+struct TimeStage {
+    uint32_t lastTime_;     // Мітка останнього кроку
+    uint32_t derivativePeriodMs_; // Мінімальний інтервал між кроками, тіки
+    uint32_t ticksPerSecond_;     // Тіків за секунду (1000 - мс, 1000000 - мкс)
+    uint32_t samplePeriod_; // Фіксований період значення, тіки (0 - за мітками)
+    uint32_t pendingTicks_; // З фіксованим періодом: інтервал, накопичений з останнього кроку
+    bool hasTime_;          // Перший крок після reset() уже був
+    TimeDelta<Fixed> delta_;
+
+    SP_CONSTEXPR TimeStage() : lastTime_(0), derivativePeriodMs_(0), ticksPerSecond_(1000),
+                  samplePeriod_(0), pendingTicks_(0), hasTime_(false)
+    {
+        delta_.ticks = 0;
+    }
+
+    SP_CONSTEXPR void timeReset() {
+        lastTime_ = 0;
+        pendingTicks_ = 0;
+        hasTime_ = false;
+    }
+
+    /**
+     * Крок часу: true, якщо стадіям треба оновитися (timeDelta().ticks == 0 - перший крок)
+     * @param time Мітка значення в тіках
+     * @param stamped Мітка передана (без неї крок можливий тільки з фіксованим періодом)
+     */
+    SP_CONSTEXPR bool timeStep(uint32_t time, bool stamped) {
+        if (samplePeriod_ == 0 && !stamped) return false;
+        // Беззнакова різниця коректна і після переходу лічильника через нуль
+        uint32_t elapsed = (samplePeriod_ != 0) ? pendingTicks_ + samplePeriod_ : time - lastTime_;
+
+        if (!hasTime_) {
+            hasTime_ = true;
+            elapsed = 0;
+        } else if (elapsed <= derivativePeriodMs_) {
+            pendingTicks_ = (samplePeriod_ != 0) ? elapsed : 0;
+            return false;
+        }
+
+        pendingTicks_ = 0;
+        if (stamped) lastTime_ = time;
+        if (elapsed != delta_.ticks) {
+            if (elapsed == 0) delta_.ticks = 0;
+            else delta_.assign(elapsed, ticksPerSecond_);
+        }
+        return true;
+    }
+
+    SP_CONSTEXPR const TimeDelta<Fixed>& timeDelta() const { return delta_; }
+    SP_CONSTEXPR uint32_t timeSamplePeriod() const { return samplePeriod_; }
+
+    /** Наступна мітка - нова точка відліку (після loadState() лічильник часу міг перезапуститися) */
+    SP_CONSTEXPR void timeRestart() {
+        pendingTicks_ = 0;
+        hasTime_ = false;
+    }
+};
+
+template<bool Fixed>
+struct TimeStage<false, Fixed> {
+    SP_CONSTEXPR void timeReset() {}
+    SP_CONSTEXPR bool timeStep(uint32_t, bool) { return false; }
+    SP_CONSTEXPR TimeDelta<Fixed> timeDelta() const { TimeDelta<Fixed> none; none.ticks = 0; return none; }
+    SP_CONSTEXPR uint32_t timeSamplePeriod() const { return 0; }
+    SP_CONSTEXPR void timeRestart() {}
+};
+
+/** Похідна raw і згладжена (SignalFeatures::Derivative) */
+template<typename T, bool Enabled>
+struct DerivativeStage {
+    T lastValue_;           // Попереднє значення
+    bool useEmaFilteredValueForDerivation_; // Чи використовуємо фільтроване значення для розрахунку похідної
+    float lastInput_;       // Попереднє значення (або EMA), від якого рахується різниця
+    float derivative_;      // Похідна (raw)
+    float derivativeFiltered_; // Згладжена похідна
+    float alphaDerivFilter_;// Коефіцієнт згладжування похідної
+    bool hasDerivative_;    // Перша похідна вже розрахована
+
+    SP_CONSTEXPR DerivativeStage()
+        : lastValue_(0), useEmaFilteredValueForDerivation_(false), lastInput_(0.0f),
+          derivative_(0.0f), derivativeFiltered_(0.0f), alphaDerivFilter_(0.2f), hasDerivative_(false)
+    {}
+
+    SP_CONSTEXPR void derivReset() {
+        lastValue_ = 0;
+        lastInput_ = 0.0f;
+        derivative_ = 0.0f;
+        derivativeFiltered_ = 0.0f;
+        hasDerivative_ = false;
+    }
+
+    /** ema - поточне значення EMA, d.ticks == 0 - перший крок (тільки запам'ятовуємо значення) */
+    SP_CONSTEXPR void derivUpdate(T value, float ema, const TimeDelta<false>& d) {
+        float input = useEmaFilteredValueForDerivation_ ? ema : (float)value;
+        if (d.ticks != 0) {
+            // Сира похідна: одне множення на закешоване 1/dt
+            float rawDerivative = (input - lastInput_) * d.invDt;
+            derivative_ = rawDerivative;
+
+            // Згладжена похідна (EMA)
+            if (!hasDerivative_) {
+                derivativeFiltered_ = rawDerivative;
+                hasDerivative_ = true;
+            } else {
+                derivativeFiltered_ = alphaDerivFilter_ * rawDerivative + (1.0f - alphaDerivFilter_) * derivativeFiltered_;
+            }
+        }
+
+        // Оновлення стану
+        lastInput_ = input;
+        lastValue_ = value;
+    }
+
+    SP_CONSTEXPR float derivValue() const { return derivative_; }
+    SP_CONSTEXPR float derivFilteredValue() const { return derivativeFiltered_; }
+    SP_CONSTEXPR void derivSetAlpha(float alpha) { alphaDerivFilter_ = alpha; }
+};
+
+template<typename T>
+struct DerivativeStage<T, false> {
+    SP_CONSTEXPR void derivReset() {}
+    SP_CONSTEXPR void derivUpdate(T, float, const TimeDelta<false>&) {}
+    SP_CONSTEXPR float derivValue() const { return 0.0f; }
+    SP_CONSTEXPR float derivFilteredValue() const { return 0.0f; }
+};
+
+/** Інтегратор, трапецоїдальний метод (SignalFeatures::Integral) */
+template<bool Enabled>
+struct IntegralStage {
+    float integrator_;      // Накопичений інтеграл
+    float lastIntegrandValue_; // Для трапецоїдального методу
+
+    SP_CONSTEXPR IntegralStage() : integrator_(0.0f), lastIntegrandValue_(0.0f) {}
+
+    SP_CONSTEXPR void integralReset() {
+        integrator_ = 0.0f;
+        lastIntegrandValue_ = 0.0f;
+    }
+
+    SP_CONSTEXPR void integralUpdate(float value, const TimeDelta<false>& d) {
+        // Інтегратор (трапецоїдальний метод для точності): одне множення-додавання
+        if (d.ticks != 0) {
+            integrator_ += (lastIntegrandValue_ + value) * d.halfDt;
+        }
+        lastIntegrandValue_ = value;
+    }
+
+    SP_CONSTEXPR float integralValue() const { return integrator_; }
+};
+
+template<>
+struct IntegralStage<false> {
+    SP_CONSTEXPR void integralReset() {}
+    SP_CONSTEXPR void integralUpdate(float, const TimeDelta<false>&) {}
+};
+
+// ----------------------------------------
+// Цілочисельні стадії (SignalFeatures::FixedPoint)
+// ----------------------------------------
+//
+// Значення 8/16-бітних T зберігаються в int32_t у Q15 (значення * 32768),
+// коефіцієнти alpha - Q15 (0 - 32768). add() виконує тільки цілі множення,
+// зсуви та додавання; float - лише в getter-ах і сеттерах.
+
+/**
+ * (x * q) >> 15 для Q15-коефіцієнта q (0 - 32768) без 64-бітного добутку:
+ * x = hi * 2^15 + lo, обидва часткові добутки вміщаються в int32_t
+ */
+SP_CONSTEXPR inline int32_t mulQ15(int32_t x, int32_t q) {
+    return (x >> 15) * q + (((x & 0x7FFF) * q) >> 15);
+}
+
+SP_CONSTEXPR inline int64_t mulQ15(int64_t x, int32_t q) {
+    return (x * q) >> 15;
+}
+
+/** Коефіцієнт 0.0 - 1.0 у Q15 (конвертація тільки в сеттерах) */
+SP_CONSTEXPR inline int32_t toQ15(float alpha) {
+    return (int32_t)(alpha * 32768.0f + 0.5f);
+}
+
+/** EMA у Q15 */
+template<typename T, bool Enabled>
+struct FixedEmaStage {
+    int32_t emaQ_;          // EMA * 32768
+    int32_t alphaEmaQ_;     // Коефіцієнт EMA у Q15
+
+    SP_CONSTEXPR FixedEmaStage() : emaQ_(0), alphaEmaQ_(toQ15(0.1f)) {}
+
+    SP_CONSTEXPR void emaReset() { emaQ_ = 0; }
+
+    /** first - перше значення у вікні (EMA стартує з нього) */
+    SP_CONSTEXPR void emaUpdate(T value, bool first) {
+        int32_t x = (int32_t)value * 32768;
+        if (first) {
+            emaQ_ = x;
+        } else {
+            // floor(alpha * (x - ema)) не виводить EMA за межі [ema, x] - переповнення немає
+            emaQ_ += mulQ15(x - emaQ_, alphaEmaQ_);
+        }
+    }
+
+    template<typename U>
+    SP_CONSTEXPR void emaUpdateBlock(const U* samples, size_t n, bool firstIsNew) {
+        for (size_t i = 0; i < n; i++) emaUpdate(samples[i], firstIsNew && i == 0);
+    }
+
+    /** Поточне значення EMA у Q15 (для похідної по фільтрованому сигналу) */
+    SP_CONSTEXPR int32_t emaOr(T) const { return emaQ_; }
+
+    SP_CONSTEXPR float emaValue() const { return (float)emaQ_ * (1.0f / 32768.0f); }
+    SP_CONSTEXPR void emaSetAlpha(float alpha) { alphaEmaQ_ = toQ15(alpha); }
+};
+
+template<typename T>
+struct FixedEmaStage<T, false> {
+    SP_CONSTEXPR void emaReset() {}
+    SP_CONSTEXPR void emaUpdate(T, bool) {}
+    template<typename U>
+    SP_CONSTEXPR void emaUpdateBlock(const U*, size_t, bool) {}
+    SP_CONSTEXPR int32_t emaOr(T value) const { return (int32_t)value * 32768; }
+    SP_CONSTEXPR float emaValue() const { return 0.0f; }
+    SP_CONSTEXPR void emaSetAlpha(float) {}
+};
+
+/**
+ * Похідна у Q15 одиниць за секунду
+ * Ділення на dt замінене множенням на закешований (ticksPerSecond << shift) / dt,
+ * який TimeStage перераховує тільки при зміні інтервалу
+ */
+template<typename T, bool Enabled>
+struct FixedDerivativeStage {
+    T lastValue_;           // Попереднє значення
+    bool useEmaFilteredValueForDerivation_; // Чи використовуємо фільтроване значення для розрахунку похідної
+    int32_t lastQ_;         // Попереднє значення (або EMA) у Q15
+    int64_t derivativeQ_;   // Похідна (raw), Q15 / с
+    int64_t derivativeFilteredQ_; // Згладжена похідна, Q15 / с
+    int32_t alphaDerivFilterQ_;   // Коефіцієнт згладжування похідної у Q15
+    bool hasDerivative_;    // Перша похідна вже розрахована
+
+    SP_CONSTEXPR FixedDerivativeStage()
+        : lastValue_(0), useEmaFilteredValueForDerivation_(false), lastQ_(0),
+          derivativeQ_(0), derivativeFilteredQ_(0), alphaDerivFilterQ_(toQ15(0.2f)), hasDerivative_(false)
+    {}
+
+    SP_CONSTEXPR void derivReset() {
+        lastValue_ = 0;
+        lastQ_ = 0;
+        derivativeQ_ = 0;
+        derivativeFilteredQ_ = 0;
+        hasDerivative_ = false;
+    }
+
+    /** emaQ - поточне значення EMA у Q15, d.ticks == 0 - перший крок */
+    SP_CONSTEXPR void derivUpdate(T value, int32_t emaQ, const TimeDelta<true>& d) {
+        int32_t v = useEmaFilteredValueForDerivation_ ? emaQ : (int32_t)value * 32768;
+        if (d.ticks != 0) {
+            // Сира похідна
+            int64_t rawDerivative = (((int64_t)v - lastQ_) * d.rateScale) >> d.rateShift;
+            derivativeQ_ = rawDerivative;
+
+            // Згладжена похідна (EMA)
+            if (!hasDerivative_) {
+                derivativeFilteredQ_ = rawDerivative;
+                hasDerivative_ = true;
+            } else {
+                derivativeFilteredQ_ += mulQ15(rawDerivative - derivativeFilteredQ_, alphaDerivFilterQ_);
+            }
+        }
+
+        // Оновлення стану
+        lastQ_ = v;
+        lastValue_ = value;
+    }
+
+    SP_CONSTEXPR float derivValue() const { return (float)derivativeQ_ * (1.0f / 32768.0f); }
+    SP_CONSTEXPR float derivFilteredValue() const { return (float)derivativeFilteredQ_ * (1.0f / 32768.0f); }
+    SP_CONSTEXPR void derivSetAlpha(float alpha) { alphaDerivFilterQ_ = toQ15(alpha); }
+};
+
+template<typename T>
+struct FixedDerivativeStage<T, false> {
+    SP_CONSTEXPR void derivReset() {}
+    SP_CONSTEXPR void derivUpdate(T, int32_t, const TimeDelta<true>&) {}
+    SP_CONSTEXPR float derivValue() const { return 0.0f; }
+    SP_CONSTEXPR float derivFilteredValue() const { return 0.0f; }
+};
+
+/** Інтегратор у цілих: сума (x[k-1] + x[k]) * ticks = інтеграл * 2 * ticksPerSecond */
+template<typename T, bool Enabled>
+struct FixedIntegralStage {
+    int64_t integratorQ_;   // Накопичений інтеграл * 2 * ticksPerSecond
+    int64_t lastIntegrandValue_; // Для трапецоїдального методу
+    uint32_t integralTicksPerSecond_; // Часова база останнього кроку
+
+    SP_CONSTEXPR FixedIntegralStage() : integratorQ_(0), lastIntegrandValue_(0), integralTicksPerSecond_(1000) {}
+
+    SP_CONSTEXPR void integralReset() {
+        integratorQ_ = 0;
+        lastIntegrandValue_ = 0;
+    }
+
+    SP_CONSTEXPR void integralUpdate(T value, const TimeDelta<true>& d) {
+        if (d.ticks != 0) {
+            integratorQ_ += (lastIntegrandValue_ + (int64_t)value) * (int64_t)d.ticks;
+            integralTicksPerSecond_ = d.ticksPerSecond;
+        }
+        lastIntegrandValue_ = value;
+    }
+
+    SP_CONSTEXPR float integralValue() const { return (float)integratorQ_ * (0.5f / (float)integralTicksPerSecond_); }
+};
+
+template<typename T>
+struct FixedIntegralStage<T, false> {
+    SP_CONSTEXPR void integralReset() {}
+    SP_CONSTEXPR void integralUpdate(T, const TimeDelta<true>&) {}
+};
+
+/** Вибір float- або Q15-реалізації EMA, похідної та інтегратора */
+template<typename T, bool Fixed, bool HasEma, bool HasDerivative, bool HasIntegral>
+struct ArithmeticSelect {
+    typedef EmaStage<HasEma> Ema;
+    typedef DerivativeStage<T, HasDerivative> Derivative;
+    typedef IntegralStage<HasIntegral> Integral;
+};
+
+template<typename T, bool HasEma, bool HasDerivative, bool HasIntegral>
+struct ArithmeticSelect<T, true, HasEma, HasDerivative, HasIntegral> {
+    typedef FixedEmaStage<T, HasEma> Ema;
+    typedef FixedDerivativeStage<T, HasDerivative> Derivative;
+    typedef FixedIntegralStage<T, HasIntegral> Integral;
+};
+
+/** Кількість біквад-секцій Lowpass за прапорцями (0 - стадія вимкнена) */
+template<uint32_t Features>
+struct LowpassSections {
+    static const uint8_t value = !(Features & SignalFeatures::Lowpass) ? 0
+        : (Features & SignalFeatures::LowpassSectionsMask) ? (uint8_t)((Features & SignalFeatures::LowpassSectionsMask) >> 12)
+        : 1;
+};
+
+/** Кількість слотів Triggers за прапорцями (0 - стадія вимкнена) */
+template<uint32_t Features>
+struct TriggerSlots {
+    static const uint8_t value = !(Features & SignalFeatures::Triggers) ? 0
+        : (Features & SignalFeatures::TriggersMask) ? (uint8_t)((Features & SignalFeatures::TriggersMask) >> 20)
+        : 1;
+};
+
+/** Кількість бінів SlidingDft за прапорцями (0 - стадія вимкнена) */
+template<uint32_t Features>
+struct SlidingDftBins {
+    static const uint8_t value = !(Features & SignalFeatures::SlidingDft) ? 0
+        : (Features & SignalFeatures::SlidingDftBinsMask) ? (uint8_t)((Features & SignalFeatures::SlidingDftBinsMask) >> 16)
+        : 1;
+};
+
+/**
+ * Ковзний DFT (SignalFeatures::SlidingDft): K бінів на довільних частотах
+ *   S(n) = r*e^(jw) * S(n-1) + x(n) - (r*e^(jw))^N * x(n-N)
+ * Фаза відраховується від найновішого значення. Коефіцієнт r = 1 - 1e-6 гасить
+ * накопичення похибки округлення (полюс трохи всередині одиничного кола).
+ * Значення x(n-N) - те саме, що add() віднімає з sum/sumSq.
+ */
+template<uint32_t N, uint8_t Bins>
+struct SlidingDftStage {
+    float dftRe_[Bins];     // Поточні значення бінів
+    float dftIm_[Bins];
+    float dftRotRe_[Bins];  // r * e^(jw)
+    float dftRotIm_[Bins];
+    float dftOutRe_[Bins];  // (r * e^(jw))^N - вага вихідного значення
+    float dftOutIm_[Bins];
+
+    SP_CONSTEXPR SlidingDftStage() {
+        for (uint8_t i = 0; i < Bins; i++) dftSetBin(i, 0.0f);
+        dftReset();
+    }
+
+    SP_CONSTEXPR void dftReset() {
+        for (uint8_t i = 0; i < Bins; i++) dftRe_[i] = dftIm_[i] = 0.0f;
+    }
+
+    /** cycles - частота біна в періодах на вікно N (k = f * N / fs, не обов'язково ціле) */
+    SP_CONSTEXPR void dftSetBin(uint8_t i, float cycles) {
+        const float r = 0.999999f;
+        float w = 6.28318531f * cycles / (float)N;
+        dftRotRe_[i] = r * mathCos(w);
+        dftRotIm_[i] = r * mathSin(w);
+        // Кут w * N = 2*pi*cycles - по дробовій частині, щоб не втрачати точність
+        float frac = cycles - mathFloor(cycles);
+        float rN = mathPow(r, N);
+        dftOutRe_[i] = rN * mathCos(6.28318531f * frac);
+        dftOutIm_[i] = rN * mathSin(6.28318531f * frac);
+    }
+
+    /** Точне значення бінів по вікну (сегменти кільця від найстарішого до найновішого) */
+    template<typename T>
+    SP_CONSTEXPR void dftResync(const T* a, uint32_t na, const T* b, uint32_t nb) {
+        dftReset();
+        for (uint32_t j = 0; j < na; j++) dftUpdate((float)a[j], 0.0f);
+        for (uint32_t j = 0; j < nb; j++) dftUpdate((float)b[j], 0.0f);
+    }
+
+    /** x - нове значення, outgoing - значення, що виходить з вікна (0, поки вікно не повне) */
+    SP_CONSTEXPR void dftUpdate(float x, float outgoing) {
+        for (uint8_t i = 0; i < Bins; i++) {
+            float re = dftRotRe_[i] * dftRe_[i] - dftRotIm_[i] * dftIm_[i];
+            float im = dftRotRe_[i] * dftIm_[i] + dftRotIm_[i] * dftRe_[i];
+            dftRe_[i] = re + x - dftOutRe_[i] * outgoing;
+            dftIm_[i] = im - dftOutIm_[i] * outgoing;
+        }
+    }
+};
+
+template<uint32_t N>
+struct SlidingDftStage<N, 0> {
+    SP_CONSTEXPR void dftReset() {}
+    template<typename T>
+    SP_CONSTEXPR void dftResync(const T*, uint32_t, const T*, uint32_t) {}
+    SP_CONSTEXPR void dftUpdate(float, float) {}
+};
+
+/** Один крок секції DF2T */
+SP_CONSTEXPR inline float biquadStep(const BiquadCoeffs& c, float& z1, float& z2, float x) {
+    float y = c.b0 * x + z1;
+    z1 = c.b1 * x - c.a1 * y + z2;
+    z2 = c.b2 * x - c.a2 * y;
+    return y;
+}
+
+/** Стан секції, що відповідає постійному входу x (старт без перехідного процесу) */
+SP_CONSTEXPR inline float biquadPrime(const BiquadCoeffs& c, float& z1, float& z2, float x) {
+    float y = c.dcGain() * x;
+    z1 = y - c.b0 * x;
+    z2 = c.b2 * x - c.a2 * y;
+    return y;
+}
+
+/**
+ * IIR-фільтр: каскад біквадів Direct Form II transposed (SignalFeatures::Lowpass)
+ * Типово - одна секція з low-pass першого порядку (alpha = 0.1)
+ */
+template<uint8_t Sections>
+struct LowpassStage {
+    BiquadCoeffs lpCoeffs_[Sections];   // Коефіцієнти секцій
+    float lpZ1_[Sections];              // Стан DF2T
+    float lpZ2_[Sections];
+    float lowpass_;                     // Вихід останньої секції
+
+    SP_CONSTEXPR LowpassStage() {
+        lpCoeffs_[0] = BiquadCoeffs::firstOrderLowpass(0.1f);
+        for (uint8_t k = 1; k < Sections; k++) lpCoeffs_[k] = BiquadCoeffs::identity();
+        lowpassReset();
+    }
+
+    SP_CONSTEXPR void lowpassReset() {
+        for (uint8_t k = 0; k < Sections; k++) lpZ1_[k] = lpZ2_[k] = 0.0f;
+        lowpass_ = 0.0f;
+    }
+
+    /** first - перше значення у вікні (стан фільтра стартує з нього) */
+    SP_CONSTEXPR void lowpassUpdate(float x, bool first) {
+        if (first) {
+            for (uint8_t k = 0; k < Sections; k++) x = biquadPrime(lpCoeffs_[k], lpZ1_[k], lpZ2_[k], x);
+        } else {
+            for (uint8_t k = 0; k < Sections; k++) x = biquadStep(lpCoeffs_[k], lpZ1_[k], lpZ2_[k], x);
+        }
+        lowpass_ = x;
+    }
+
+    /** Блок: стан секцій тримається в локальних змінних на весь прохід */
+    template<typename T>
+    SP_CONSTEXPR void lowpassUpdateBlock(const T* samples, size_t n, bool firstIsNew) {
+        size_t i = 0;
+        if (firstIsNew) lowpassUpdate((float)samples[i++], true);
+        float z1[Sections], z2[Sections];
+        for (uint8_t k = 0; k < Sections; k++) { z1[k] = lpZ1_[k]; z2[k] = lpZ2_[k]; }
+        float y = lowpass_;
+        for (; i < n; i++) {
+            y = (float)samples[i];
+            for (uint8_t k = 0; k < Sections; k++) y = biquadStep(lpCoeffs_[k], z1[k], z2[k], y);
+        }
+        for (uint8_t k = 0; k < Sections; k++) { lpZ1_[k] = z1[k]; lpZ2_[k] = z2[k]; }
+        lowpass_ = y;
+    }
+
+    SP_CONSTEXPR float lowpassValue() const { return lowpass_; }
+};
+
+template<>
+struct LowpassStage<0> {
+    SP_CONSTEXPR void lowpassReset() {}
+    SP_CONSTEXPR void lowpassUpdate(float, bool) {}
+    template<typename T>
+    SP_CONSTEXPR void lowpassUpdateBlock(const T*, size_t, bool) {}
+    SP_CONSTEXPR float lowpassValue() const { return 0.0f; }
+};
+
+/** Кеш знімка статистики (SignalFeatures::StatsCache) */
+template<bool Enabled, typename Stats>
+struct StatsCacheStage {
+    mutable Stats stats_;       // Останній обчислений знімок
+    mutable float rms_;         // Останній обчислений getRms()
+    mutable bool statsValid_;   // Знімок актуальний (після нього не було add())
+    mutable bool rmsValid_;
+
+    SP_CONSTEXPR StatsCacheStage() : rms_(0.0f), statsValid_(false), rmsValid_(false) {}
+
+    // Під час компіляції кеш не читається і не заповнюється (mutable, див. LazyMinMax);
+    // скидання - лише запис, тому виконується завжди
+    SP_CONSTEXPR void statsInvalidate() {
+        statsValid_ = false;
+        rmsValid_ = false;
+    }
+
+    SP_CONSTEXPR bool statsLoad(Stats& out) const {
+        if (isConstantEvaluated() || !statsValid_) return false;
+        out = stats_;
+        return true;
+    }
+
+    SP_CONSTEXPR void statsStore(const Stats& s) const {
+        if (isConstantEvaluated()) return;
+        stats_ = s;
+        statsValid_ = true;
+    }
+
+    SP_CONSTEXPR bool rmsLoad(float& out) const {
+        if (isConstantEvaluated() || !rmsValid_) return false;
+        out = rms_;
+        return true;
+    }
+
+    SP_CONSTEXPR void rmsStore(float rms) const {
+        if (isConstantEvaluated()) return;
+        rms_ = rms;
+        rmsValid_ = true;
+    }
+};
+
+template<typename Stats>
+struct StatsCacheStage<false, Stats> {
+    SP_CONSTEXPR void statsInvalidate() {}
+    SP_CONSTEXPR bool statsLoad(Stats&) const { return false; }
+    SP_CONSTEXPR void statsStore(const Stats&) const {}
+    SP_CONSTEXPR bool rmsLoad(float&) const { return false; }
+    SP_CONSTEXPR void rmsStore(float) const {}
+};
+
+/** Лічильники гарячого шляху (SignalFeatures::Instrumentation) */
+template<bool Enabled>
+struct InstrumentationStage {
+    mutable SignalCounters counters_;   // Перерахунок min/max рахується в const getter-ах
+    SignalCounters::Clock clock_;       // 0 - такти не вимірюються
+
+    InstrumentationStage() : clock_(0) { counters_.reset(); }
+
+    void instrSamples(uint32_t n) { counters_.samples += n; }
+    void instrRescan(uint32_t scanned) const {
+        counters_.minMaxRescans++;
+        counters_.minMaxScanned += scanned;
+    }
+    void instrDerivativeSkipped() { counters_.derivativeSkipped++; }
+
+    uint32_t instrBegin() const { return (clock_ != 0) ? clock_() : 0; }
+    void instrEndAdd(uint32_t t0) { if (clock_ != 0) counters_.addCycles.record(clock_() - t0); }
+    void instrEndBlock(uint32_t t0) { if (clock_ != 0) counters_.addBlockCycles.record(clock_() - t0); }
+};
+
+template<>
+struct InstrumentationStage<false> {
+    SP_CONSTEXPR void instrSamples(uint32_t) {}
+    SP_CONSTEXPR void instrRescan(uint32_t) const {}
+    SP_CONSTEXPR void instrDerivativeSkipped() {}
+    SP_CONSTEXPR uint32_t instrBegin() const { return 0; }
+    SP_CONSTEXPR void instrEndAdd(uint32_t) {}
+    SP_CONSTEXPR void instrEndBlock(uint32_t) {}
+};
+
+/**
+ * Впорядкована копія вікна (SignalFeatures::Median): медіана, перцентилі, MAD
+ * Позиція шукається бінарним пошуком O(log N), заміна вихідного значення новим -
+ * один memmove тільки елементів між їхніми рангами (для повільного сигналу - кілька).
+ * Запити - O(1) для перцентиля, O(N/2) для MAD (злиття від медіани в обидва боки).
+ */
+template<typename T, uint32_t N, bool Enabled>
+struct MedianStage {
+    T sorted_[N];           // Значення вікна за зростанням
+
+    /** Перша позиція в [lo, hi) з sorted_[i] >= v */
+    SP_CONSTEXPR uint32_t lowerBound(T v, uint32_t lo, uint32_t hi) const {
+        while (lo < hi) {
+            uint32_t mid = lo + ((hi - lo) >> 1);
+            if (sorted_[mid] < v) lo = mid + 1; else hi = mid;
+        }
+        return lo;
+    }
+
+    /** Перша позиція в [lo, hi) з sorted_[i] > v */
+    SP_CONSTEXPR uint32_t upperBound(T v, uint32_t lo, uint32_t hi) const {
+        while (lo < hi) {
+            uint32_t mid = lo + ((hi - lo) >> 1);
+            if (v < sorted_[mid]) hi = mid; else lo = mid + 1;
+        }
+        return lo;
+    }
+
+    /** Вікно ще не повне: count - кількість значень до вставки */
+    SP_CONSTEXPR void medianInsert(T value, uint32_t count) {
+        uint32_t pos = upperBound(value, 0, count);
+        moveValues(&sorted_[pos + 1], &sorted_[pos], count - pos);
+        sorted_[pos] = value;
+    }
+
+    /** Повне вікно: outgoing (присутнє у вікні) замінюється на value */
+    SP_CONSTEXPR void medianReplace(T outgoing, T value) {
+        uint32_t from = lowerBound(outgoing, 0, N);
+        if (outgoing < value) {
+            // Елементи (from, to) зсуваються на одну позицію вліво
+            uint32_t to = lowerBound(value, from + 1, N);
+            moveValues(&sorted_[from], &sorted_[from + 1], to - 1 - from);
+            sorted_[to - 1] = value;
+        } else if (value < outgoing) {
+            // Елементи [to, from) зсуваються на одну позицію вправо
+            uint32_t to = upperBound(value, 0, from);
+            moveValues(&sorted_[to + 1], &sorted_[to], from - to);
+            sorted_[to] = value;
+        }
+    }
+
+    /** Вікно з n значень src заново (n <= N, порядок src неважливий) - heapsort, O(n log n) */
+    SP_CONSTEXPR void medianRebuild(const T* src, uint32_t n) {
+        copyValues(sorted_, src, n);
+        for (uint32_t i = n / 2; i > 0; i--) siftDown(i - 1, n);
+        for (uint32_t end = (n > 0) ? n - 1 : 0; end > 0; end--) {
+            T t = sorted_[0]; sorted_[0] = sorted_[end]; sorted_[end] = t;
+            siftDown(0, end);
+        }
+    }
+
+    SP_CONSTEXPR void siftDown(uint32_t root, uint32_t n) {
+        T v = sorted_[root];
+        for (;;) {
+            uint32_t child = 2 * root + 1;
+            if (child >= n) break;
+            if (child + 1 < n && sorted_[child] < sorted_[child + 1]) child++;
+            if (!(v < sorted_[child])) break;
+            sorted_[root] = sorted_[child];
+            root = child;
+        }
+        sorted_[root] = v;
+    }
+
+    /** Квантиль q (0 - 1) з лінійною інтерполяцією між рангами, count > 0 */
+    SP_CONSTEXPR float quantile(float q, uint32_t count) const {
+        float pos = q * (float)(count - 1);
+        uint32_t i = (uint32_t)pos;
+        if (i >= count - 1) return (float)sorted_[count - 1];
+        float frac = pos - (float)i;
+        return (float)sorted_[i] + frac * ((float)sorted_[i + 1] - (float)sorted_[i]);
+    }
+
+    /** Медіана абсолютних відхилень від median, count > 0 */
+    SP_CONSTEXPR float mad(float median, uint32_t count) const {
+        // Відхилення за зростанням - злиття двох впорядкованих послідовностей від медіани
+        uint32_t lo = 0, hi = count;
+        while (lo < hi) {
+            uint32_t mid = lo + ((hi - lo) >> 1);
+            if ((float)sorted_[mid] < median) lo = mid + 1; else hi = mid;
+        }
+        uint32_t r = lo;                 // Перше значення >= медіани
+        int32_t l = (int32_t)r - 1;      // Останнє значення < медіани
+        uint32_t lowRank = (count - 1) / 2, highRank = count / 2;
+        float lowDev = 0.0f, dev = 0.0f;
+        for (uint32_t k = 0; k <= highRank; k++) {
+            float dl = (l >= 0) ? median - (float)sorted_[l] : -1.0f;
+            float dr = (r < count) ? (float)sorted_[r] - median : -1.0f;
+            if (dr < 0.0f || (dl >= 0.0f && dl < dr)) { dev = dl; l--; }
+            else { dev = dr; r++; }
+            if (k == lowRank) lowDev = dev;
+        }
+        return 0.5f * (lowDev + dev);
+    }
+};
+
+/** Слот порогового тригера */
+struct TriggerSlot {
+    SignalTrigger::Callback callback;   // 0 - слот вільний
+    void* context;
+    float onLevel;          // Поріг спрацювання (для StdDev - у квадраті)
+    float offLevel;         // Поріг скидання з гістерезисом (для StdDev - у квадраті)
+    uint32_t run;           // Кількість значень поспіль з виконаною умовою
+    uint16_t hold;          // Потрібна кількість значень поспіль
+    uint8_t metric;         // SignalTrigger::Metric
+    uint8_t condition;      // SignalTrigger::Condition
+    bool active;            // Поточний стан
+};
+
+/**
+ * Порогові тригери (SignalFeatures::Triggers)
+ * Величини обчислює процесор; стадія тримає слоти і автомат станів
+ */
+template<uint8_t Slots>
+struct TriggerStage {
+    TriggerSlot triggers_[Slots];
+    uint8_t triggerCount_;  // Кількість зайнятих слотів (0 - перевірка пропускається)
+
+    SP_CONSTEXPR TriggerStage() : triggerCount_(0) {
+        for (uint8_t i = 0; i < Slots; i++) triggers_[i].callback = 0;
+    }
+
+    SP_CONSTEXPR uint8_t triggersUsed() const { return triggerCount_; }
+
+    /** Величина слота (SignalTrigger::Metric) або 0xFF для вільного слота */
+    SP_CONSTEXPR uint8_t triggerMetric(uint8_t id) const {
+        return triggers_[id].callback ? triggers_[id].metric : (uint8_t)0xFF;
+    }
+
+    /** Скидання станів без виклику callback-ів */
+    SP_CONSTEXPR void triggersReset() {
+        for (uint8_t i = 0; i < Slots; i++) {
+            triggers_[i].run = 0;
+            triggers_[i].active = false;
+        }
+    }
+
+    /**
+     * Крок автомата: x порівнюється з level * scale (scale > 0 - кількість для Mean/StdDev)
+     * @param samples Кількість нових значень з попередньої перевірки
+     */
+    template<typename V>
+    SP_CONSTEXPR void triggerStep(uint8_t id, V x, V scale, uint32_t samples) {
+        TriggerSlot& t = triggers_[id];
+        bool above = (t.condition == SignalTrigger::Above);
+        if (!t.active) {
+            V on = (V)t.onLevel * scale;
+            if (above ? (x > on) : (x < on)) {
+                t.run += samples;
+                if (t.run >= t.hold) {
+                    t.active = true;
+                    t.run = 0;
+                    t.callback(t.context, id, true);
+                }
+            } else {
+                t.run = 0;
+            }
+        } else {
+            V off = (V)t.offLevel * scale;
+            // StdDev: скидання включно з рівнем - n * sumSq - sum^2 не буває < 0,
+            // тож рівень скидання 0 (відступ >= порогу) досягається сталим сигналом
+            bool release = above ? (x < off || (x == off && t.metric == SignalTrigger::StdDev)) : (x > off);
+            if (release) {
+                t.active = false;
+                t.callback(t.context, id, false);
+            }
+        }
+    }
+};
+
+template<>
+struct TriggerStage<0> {
+    SP_CONSTEXPR void triggersReset() {}
+    SP_CONSTEXPR uint8_t triggersUsed() const { return 0; }
+    SP_CONSTEXPR uint8_t triggerMetric(uint8_t) const { return 0xFF; }
+    template<typename V>
+    SP_CONSTEXPR void triggerStep(uint8_t, V, V, uint32_t) {}
+};
+
+template<typename T, uint32_t N>
+struct MedianStage<T, N, false> {
+    SP_CONSTEXPR void medianInsert(T, uint32_t) {}
+    SP_CONSTEXPR void medianReplace(T, T) {}
+    SP_CONSTEXPR void medianRebuild(const T*, uint32_t) {}
+};
+
+// ========================================
+// ТАБЛИЦІ FFT ЧАСУ КОМПІЛЯЦІЇ
+// ========================================
+
+/** Послідовність індексів 0..N-1 (аналог std::index_sequence для C++11) */
+template<uint32_t... I> struct IndexSeq {};
+
+template<class A, class B> struct ConcatSeq;
+template<uint32_t... I, uint32_t... J>
+struct ConcatSeq<IndexSeq<I...>, IndexSeq<J...> > {
+    typedef IndexSeq<I..., (uint32_t)(sizeof...(I) + J)...> type;
+};
+
+/** Глибина рекурсії - log2(N), а не N (для вікон на тисячі семплів) */
+template<uint32_t N>
+struct MakeSeq {
+    typedef typename ConcatSeq<typename MakeSeq<N / 2>::type, typename MakeSeq<N - N / 2>::type>::type type;
+};
+template<> struct MakeSeq<0> { typedef IndexSeq<> type; };
+template<> struct MakeSeq<1> { typedef IndexSeq<0> type; };
+
+/** cos(x) для x у [0, pi/2]: ряд Тейлора до x^22 (точність double) */
+constexpr double cxCosSeries(double x2, double term, int n) {
+    return (n > 22) ? 0.0 : term + cxCosSeries(x2, -term * x2 / (double)((n + 1) * (n + 2)), n + 2);
+}
+
+/** cos(2*pi*k/n) з точною редукцією до першого квадранта за цілими k, n */
+constexpr double cxCos2Pi(uint64_t k, uint64_t n) {
+    return (4 * k <= n) ? cxCosSeries(6.283185307179586 * k / n * (6.283185307179586 * k / n), 1.0, 0)
+         : (4 * k <= 2 * n) ? -cxCos2Pi(n - 2 * k, 2 * n)
+         : (4 * k <= 3 * n) ? -cxCos2Pi(2 * k - n, 2 * n)
+         : cxCos2Pi(n - k, n);
+}
+
+/** Вікно у точці i з n (періодичне, для спектрального аналізу) */
+constexpr double cxWindow(int type, uint32_t i, uint32_t n) {
+    return (type == SpectrumWindow::Hann) ? 0.5 - 0.5 * cxCos2Pi(i, n)
+         : (type == SpectrumWindow::Hamming) ? 0.54 - 0.46 * cxCos2Pi(i, n)
+         : (type == SpectrumWindow::Blackman) ? 0.42 - 0.5 * cxCos2Pi(i, n) + 0.08 * cxCos2Pi(2 * (uint64_t)i % n, n)
+         : 1.0;
+}
+
+template<uint32_t N, int Window, class Seq = typename MakeSeq<N>::type>
+struct WindowTable;
+
+template<uint32_t N, int Window, uint32_t... I>
+struct WindowTable<N, Window, IndexSeq<I...> > {
+    static constexpr float value[N] = { (float)cxWindow(Window, I, N)... };
+};
+
+#if __cplusplus < 201703L   // З C++17 constexpr static - неявно inline
+template<uint32_t N, int Window, uint32_t... I>
+constexpr float WindowTable<N, Window, IndexSeq<I...> >::value[N];
+#endif
+
+/** Поворотні множники W_N^k = cos - j*sin для k < N/2 */
+template<uint32_t N, class Seq = typename MakeSeq<N / 2>::type>
+struct TwiddleTable;
+
+template<uint32_t N, uint32_t... I>
+struct TwiddleTable<N, IndexSeq<I...> > {
+    static constexpr float cosv[N / 2] = { (float)cxCos2Pi(I, N)... };
+    static constexpr float sinv[N / 2] = { (float)cxCos2Pi((I + 3 * N / 4) % N, N)... };
+};
+
+#if __cplusplus < 201703L
+template<uint32_t N, uint32_t... I>
+constexpr float TwiddleTable<N, IndexSeq<I...> >::cosv[N / 2];
+template<uint32_t N, uint32_t... I>
+constexpr float TwiddleTable<N, IndexSeq<I...> >::sinv[N / 2];
+#endif
+
+/**
+ * Дійсне FFT на N точок через комплексне radix-2 FFT на N/2 точок
+ * Вхід: data[0..N) - дійсні значення, вже переставлені парами за bit-reverse (див. computeSpectrum)
+ * Вихід: упакований спектр (SpectrumOutput::Complex)
+ */
+template<uint32_t N>
+struct RealFft {
+    static const uint32_t M = N / 2;    // Кількість комплексних точок
+
+    static SP_CONSTEXPR void run(float* data) {
+        const float* cw = TwiddleTable<N>::cosv;
+        const float* sw = TwiddleTable<N>::sinv;
+
+        // Комплексне FFT (децимація в часі), W_M^k = W_N^(2k)
+        for (uint32_t half = 1; half < M; half <<= 1) {
+            const uint32_t step = N / (2 * half);
+            for (uint32_t base = 0; base < M; base += 2 * half) {
+                for (uint32_t k = 0; k < half; k++) {
+                    float wr = cw[k * step], wi = -sw[k * step];
+                    float* a = data + 2 * (base + k);
+                    float* b = data + 2 * (base + k + half);
+                    float tr = wr * b[0] - wi * b[1];
+                    float ti = wr * b[1] + wi * b[0];
+                    b[0] = a[0] - tr;
+                    b[1] = a[1] - ti;
+                    a[0] += tr;
+                    a[1] += ti;
+                }
+            }
+        }
+
+        // Розділення на спектр дійсного сигналу: X[k] = Fe + W_N^k * Fo
+        float z0r = data[0], z0i = data[1];
+        data[0] = z0r + z0i;    // X[0]
+        data[1] = z0r - z0i;    // X[N/2]
+        for (uint32_t k = 1; k <= M / 2; k++) {
+            float* zk = data + 2 * k;
+            float* zm = data + 2 * (M - k);
+            float fer = 0.5f * (zk[0] + zm[0]), fei = 0.5f * (zk[1] - zm[1]);
+            float dr = 0.5f * (zk[0] - zm[0]), di = 0.5f * (zk[1] + zm[1]);
+            // Fo = -j * d
+            float forr = di, foi = -dr;
+            float wr = cw[k], wi = -sw[k];
+            float tr = wr * forr - wi * foi;
+            float ti = wr * foi + wi * forr;
+            zk[0] = fer + tr;
+            zk[1] = fei + ti;
+            if (k != M - k) {
+                zm[0] = fer - tr;
+                zm[1] = -(fei - ti);
+            }
+        }
+    }
+};
+
+} // namespace sp_detail
+
+// ========================================
+// АКУМУЛЯТОРИ СУМ (четвертий шаблонний параметр)
+// ========================================
+//
+// Кожен акумулятор веде одну ковзну суму (процесор тримає два: для значень і для квадратів).
+// Інтерфейс:
+//   Term  - тип доданка (значення або квадрат значення)
+//   Value - тип, у якому getter-и обчислюють mean/variance
+//   reset(), add(Term), sub(Term), value()
+
+/** Звичайна float-сума (типовий режим, як у версії 1.0) */
+template<typename T>
+class FloatAccumulator {
+    float acc_;
+
+public:
+    typedef float Term;
+    typedef float Value;
+
+    SP_CONSTEXPR FloatAccumulator() : acc_(0.0f) {}
+
+    SP_CONSTEXPR void reset() { acc_ = 0.0f; }
+    SP_CONSTEXPR void add(Term x) { acc_ += x; }
+    SP_CONSTEXPR void sub(Term x) { acc_ -= x; }
+    SP_CONSTEXPR Value value() const { return acc_; }
+};
+
+/**
+ * Float-сума з компенсацією Кехена
+ * Похибка не накопичується з кількістю додавань/віднімань.
+ * УВАГА: -ffast-math знищує компенсацію, компілюйте без нього
+ */
+template<typename T>
+class KahanAccumulator {
+    float acc_;
+    float comp_;            // Втрачені молодші біти
+
+public:
+    typedef float Term;
+    typedef float Value;
+
+    SP_CONSTEXPR KahanAccumulator() : acc_(0.0f), comp_(0.0f) {}
+
+    SP_CONSTEXPR void reset() { acc_ = 0.0f; comp_ = 0.0f; }
+
+    SP_CONSTEXPR void add(Term x) {
+        float y = x - comp_;
+        float t = acc_ + y;
+        comp_ = (t - acc_) - y;
+        acc_ = t;
+    }
+
+    SP_CONSTEXPR void sub(Term x) { add(-x); }
+    SP_CONSTEXPR Value value() const { return acc_; }
+};
+
+/** Сума в double (на Cortex-M4F/M7 без DP FPU - програмна емуляція) */
+template<typename T>
+class DoubleAccumulator {
+    double acc_;
+
+public:
+    typedef double Term;
+    typedef double Value;
+
+    SP_CONSTEXPR DoubleAccumulator() : acc_(0.0) {}
+
+    SP_CONSTEXPR void reset() { acc_ = 0.0; }
+    SP_CONSTEXPR void add(Term x) { acc_ += x; }
+    SP_CONSTEXPR void sub(Term x) { acc_ -= x; }
+    SP_CONSTEXPR Value value() const { return acc_; }
+};
+
+/**
+ * Точна сума в int64_t для цілих T
+ * Додавання/віднімання без округлення - статистика не дрейфує ніколи.
+ * Квадрати мають вміщатися: N * max|x|^2 < 2^63 (для 16-бітних T - будь-яке N)
+ */
+template<typename T>
+class ExactAccumulator {
+    static_assert(sp_detail::IsIntegral<T>::value, "ExactAccumulator requires an integral sample type");
+
+    int64_t acc_;
+
+public:
+    typedef int64_t Term;
+    typedef double Value;
+
+    SP_CONSTEXPR ExactAccumulator() : acc_(0) {}
+
+    SP_CONSTEXPR void reset() { acc_ = 0; }
+    SP_CONSTEXPR void add(Term x) { acc_ += x; }
+    SP_CONSTEXPR void sub(Term x) { acc_ -= x; }
+    SP_CONSTEXPR Value value() const { return (Value)acc_; }
+};
+
+// ========================================
+// ЗНІМОК СТАТИСТИКИ
+// ========================================
+
+/**
+ * Узгоджений знімок статистики вікна (getStats())
+ * Поля вимкнених стадій дорівнюють 0. Типи полів фіксовані - структуру можна
+ * передавати в телеметрію як є (memcpy).
+ */
+template<typename T>
+struct SignalStats {
+    uint32_t count;         // Кількість значень у вікні
+    float mean;             // Середнє
+    float variance;         // Sample variance
+    float stdDev;           // Стандартне відхилення
+    float cv;               // Коефіцієнт варіації, %
+    float range;            // max - min
+    float ema;              // Exponential Moving Average
+    T min;                  // Мінімум
+    T max;                  // Максимум
+};
+
+/**
+ * Зведення вікна, що об'єднується (summary(), combine())
+ * Для агрегації по каналах, вузлах і флоту без передачі сирих буферів:
+ * combine() асоціативний і комутативний, тому дерево агрегації збирається в
+ * будь-якому порядку і паралельно - O(вузлів) замість O(вузлів * N).
+ * Дисперсія - через M2 (сума квадратів відхилень від середнього) за формулою
+ * Chan et al.: без катастрофічного віднімання великих sumSq і sum^2 / n.
+ */
+template<typename T>
+struct SignalSummary {
+    uint64_t count;         // Кількість значень
+    double sum;             // Сума
+    double sumSq;           // Сума квадратів
+    double mean;            // Середнє
+    double m2;              // Сума квадратів відхилень від середнього
+    T min;                  // Мінімум
+    T max;                  // Максимум
+
+    SP_CONSTEXPR SignalSummary() : count(0), sum(0.0), sumSq(0.0), mean(0.0), m2(0.0), min(0), max(0) {}
+
+    /** Зведення з сум вікна (count > 0) */
+    static SP_CONSTEXPR SignalSummary fromSums(uint64_t count, double sum, double sumSq, T min, T max) {
+        SignalSummary s;
+        if (count == 0) return s;
+        s.count = count;
+        s.sum = sum;
+        s.sumSq = sumSq;
+        s.mean = sum / (double)count;
+        double m2 = sumSq - sum * s.mean;
+        s.m2 = (m2 > 0.0) ? m2 : 0.0;
+        s.min = min;
+        s.max = max;
+        return s;
+    }
+
+    /** Об'єднання двох зведень (порядок аргументів неважливий) */
+    static SP_CONSTEXPR SignalSummary combine(const SignalSummary& a, const SignalSummary& b) {
+        if (a.count == 0) return b;
+        if (b.count == 0) return a;
+        SignalSummary s;
+        s.count = a.count + b.count;
+        s.sum = a.sum + b.sum;
+        s.sumSq = a.sumSq + b.sumSq;
+        double delta = b.mean - a.mean;
+        double wb = (double)b.count / (double)s.count;
+        s.mean = a.mean + delta * wb;
+        s.m2 = a.m2 + b.m2 + delta * delta * (double)a.count * wb;
+        s.min = (b.min < a.min) ? b.min : a.min;
+        s.max = (b.max > a.max) ? b.max : a.max;
+        return s;
+    }
+
+    /** Додавання іншого зведення до цього */
+    SP_CONSTEXPR SignalSummary& merge(const SignalSummary& other) {
+        *this = combine(*this, other);
+        return *this;
+    }
+
+    /** Sample variance (незміщена оцінка, як SignalProcessor::getVariance()) */
+    SP_CONSTEXPR double variance() const { return (count > 1) ? m2 / (double)(count - 1) : 0.0; }
+
+    SP_CONSTEXPR double stdDev() const { return sp_detail::mathSqrt(variance()); }
+
+    SP_CONSTEXPR double range() const { return (count > 0) ? (double)max - (double)min : 0.0; }
+};
+
+// ========================================
+// УПОРЯДКОВАНЕ ПРЕДСТАВЛЕННЯ БУФЕРА
+// ========================================
+
 /**
- * @brief Універсальний процесор сигналів для embedded систем
- * 
- * Призначення:
- *  - Обробка сигналів сенсорів (акселерометр, гіроскоп, температура, тощо)
- *  - Моніторинг аналогових сигналів (напруга, струм, потужність)
- *  - Обробка даних з АЦП
- *  - Контроль якості сигналів
- *  - Real-time фільтрація та аналіз
- * 
- * Можливості:
- *  - Базова статистика: Mean, Min, Max, StdDev, Variance, Range
- *  - Фільтри: EMA, SMA, Low-pass
- *  - Похідна (raw і згладжена)
- *  - Інтегратор (трапецоїдальний метод)
- *  - Виявлення викидів (outlier detection)
- *  - Контроль стабільності сигналу
- * 
- * Шаблонні параметри:
- *   T — тип даних (float, double, int16_t, int32_t, uint16_t)
- *   N — розмір циклічного буфера (від 2 до 65535)
- * 
- * Використання пам'яті: N * sizeof(T) + ~50 байт
- * 
- * @author Korzhak
- * @version 1.0
- * @date 2025
+ * Вміст циклічного буфера в хронологічному порядку без копіювання (getView())
+ * Два суцільні сегменти: first - від найстарішого значення до кінця масиву,
+ * second - з початку масиву до позиції запису. Логічний індекс 0 - найстаріше значення.
+ * Представлення дійсне до наступного add()/addBlock()/reset().
+ *
+ *   RingView<int16_t> v = adc.getView();
+ *   memcpy(log, v.first, v.firstSize * sizeof(int16_t));
+ *   memcpy(log + v.firstSize, v.second, v.secondSize * sizeof(int16_t));
+ *   int16_t top = *std::max_element(v.begin(), v.end());
  */
-template<typename T, uint16_t N>
-class SignalProcessor {
-    static_assert(N >= 2, "Buffer size must be at least 2");
-    
+template<typename T>
+struct RingView {
+    const T* first;         // [найстаріше .. кінець масиву)
+    uint32_t firstSize;
+    const T* second;        // [початок масиву .. позиція запису)
+    uint32_t secondSize;
+
+    /** Кількість значень */
+    SP_CONSTEXPR uint32_t size() const { return firstSize + secondSize; }
+    SP_CONSTEXPR bool empty() const { return size() == 0; }
+
+    /** Значення за логічним індексом (0 - найстаріше) */
+    SP_CONSTEXPR const T& operator[](uint32_t i) const {
+        return (i < firstSize) ? first[i] : second[i - firstSize];
+    }
+
+    /** k-те значення з кінця (0 - найновіше) */
+    SP_CONSTEXPR const T& latest(uint32_t k) const { return (*this)[size() - 1 - k]; }
+
+    /** Копіювання в хронологічному порядку (два memcpy), dst - не менше size() елементів */
+    void copyTo(T* dst) const {
+        if (firstSize > 0) memcpy(dst, first, firstSize * sizeof(T));
+        if (secondSize > 0) memcpy(dst + firstSize, second, secondSize * sizeof(T));
+    }
+
+    /** Ітератор довільного доступу в логічному порядку */
+    class iterator {
+        const RingView* view_;
+        uint32_t i_;
+
+    public:
+        typedef T value_type;
+        typedef int32_t difference_type;
+        typedef const T* pointer;
+        typedef const T& reference;
+#ifdef SIGNAL_PROCESSOR_HAS_STD_ITERATOR
+        typedef std::random_access_iterator_tag iterator_category;
+#endif
+
+        SP_CONSTEXPR iterator() : view_(0), i_(0) {}
+        SP_CONSTEXPR iterator(const RingView* view, uint32_t i) : view_(view), i_(i) {}
+
+        SP_CONSTEXPR reference operator*() const { return (*view_)[i_]; }
+        SP_CONSTEXPR pointer operator->() const { return &(*view_)[i_]; }
+        SP_CONSTEXPR reference operator[](difference_type n) const { return (*view_)[(uint32_t)(i_ + n)]; }
+
+        SP_CONSTEXPR iterator& operator++() { i_++; return *this; }
+        SP_CONSTEXPR iterator operator++(int) { iterator t = *this; i_++; return t; }
+        SP_CONSTEXPR iterator& operator--() { i_--; return *this; }
+        SP_CONSTEXPR iterator operator--(int) { iterator t = *this; i_--; return t; }
+        SP_CONSTEXPR iterator& operator+=(difference_type n) { i_ += n; return *this; }
+        SP_CONSTEXPR iterator& operator-=(difference_type n) { i_ -= n; return *this; }
+        SP_CONSTEXPR iterator operator+(difference_type n) const { return iterator(view_, i_ + n); }
+        SP_CONSTEXPR iterator operator-(difference_type n) const { return iterator(view_, i_ - n); }
+        friend SP_CONSTEXPR iterator operator+(difference_type n, const iterator& it) { return it + n; }
+        SP_CONSTEXPR difference_type operator-(const iterator& o) const { return (difference_type)i_ - (difference_type)o.i_; }
+
+        SP_CONSTEXPR bool operator==(const iterator& o) const { return i_ == o.i_; }
+        SP_CONSTEXPR bool operator!=(const iterator& o) const { return i_ != o.i_; }
+        SP_CONSTEXPR bool operator<(const iterator& o) const { return i_ < o.i_; }
+        SP_CONSTEXPR bool operator>(const iterator& o) const { return i_ > o.i_; }
+        SP_CONSTEXPR bool operator<=(const iterator& o) const { return i_ <= o.i_; }
+        SP_CONSTEXPR bool operator>=(const iterator& o) const { return i_ >= o.i_; }
+    };
+
+    typedef iterator const_iterator;
+
+    SP_CONSTEXPR iterator begin() const { return iterator(this, 0); }
+    SP_CONSTEXPR iterator end() const { return iterator(this, size()); }
+};
+
+// ========================================
+// FIR-ФІЛЬТРИ
+// ========================================
+
+/**
+ * FIR-фільтр з коефіцієнтами часу компіляції для SignalProcessor::getFir()
+ * Фільтр працює прямо над циклічним буфером процесора - окрема лінія затримки не потрібна.
+ *
+ * Коефіцієнти зіставляються з вікном у хронологічному порядку: Taps[K - 1] множиться
+ * на найновіше значення, Taps[0] - на значення K - 1 семплів тому. Для симетричних
+ * (лінійна фаза) фільтрів це звичайна згортка; для узгодженого фільтра - шаблон як є.
+ *
+ *   static const float kAntiAlias[5] = { 0.1f, 0.2f, 0.4f, 0.2f, 0.1f };
+ *   typedef FirTaps<float, 5, kAntiAlias> AntiAlias;
+ *   float y = processor.getFir<AntiAlias>();
+ *
+ * Tap = float - обчислення у float для будь-якого T.
+ * Tap = int16_t - Q15: семпли int16_t, 64-бітний акумулятор, вихід Q15 з насиченням.
+ */
+template<typename Tap, uint32_t K, const Tap (&Taps)[K]>
+struct FirTaps {
+    static_assert(K >= 1, "FIR needs at least one tap");
+
+    typedef sp_detail::FirMac<Tap> Mac;
+    typedef typename Mac::Acc Acc;
+    typedef typename Mac::Output Output;
+
+    static const uint32_t kLength = K;
+
+    /** Внесок сегмента вікна x[0..n), що відповідає коефіцієнтам Taps[first..first + n) */
+    template<typename T>
+    static Acc mac(const T* x, uint32_t first, uint32_t n) {
+        return Mac::dot(x, Taps + first, n);
+    }
+
+    static Output output(Acc acc) { return Mac::output(acc); }
+};
+
+/**
+ * @brief Спільне ядро SignalProcessor і SignalProcessorDyn
+ *
+ * Кільце, стадії, add()/addBlock() і getter-и - тут; похідні класи задають лише
+ * політику кільця і конструктори:
+ *   sp_detail::Ring<N> - ємність часу компіляції (маска для N = 2^k), буфер T[N] або пам'ять користувача
+ *   sp_detail::DynRing - ємність часу виконання (SignalProcessorDyn.hpp), буфер з арени
+ * RingPolicy::kCapacity - ємність для стадій, пам'ять яких залежить від N
+ * (для DynRing - найбільша, такі стадії там вимкнені).
+ */
+template<typename T, class RingPolicy, uint32_t Features, template<typename> class Accumulator>
+class SignalProcessorCore
+    : private RingPolicy,
+      private sp_detail::SumStage<(Features & (SignalFeatures::Mean | SignalFeatures::Variance)) != 0, Accumulator<T> >,
+      private sp_detail::SumSqStage<(Features & SignalFeatures::Variance) != 0, Accumulator<T> >,
+      private sp_detail::MinMaxSelect<T, RingPolicy::kCapacity,
+          (Features & (SignalFeatures::MinMax | SignalFeatures::MinMaxWedge)) != 0,
+          (Features & SignalFeatures::MinMaxWedge) != 0>::type,
+      private sp_detail::ArithmeticSelect<T, (Features & SignalFeatures::FixedPoint) != 0,
+          (Features & SignalFeatures::Ema) != 0, (Features & SignalFeatures::Derivative) != 0,
+          (Features & SignalFeatures::Integral) != 0>::Ema,
+      private sp_detail::TimeStage<(Features & (SignalFeatures::Derivative | SignalFeatures::Integral)) != 0,
+          (Features & SignalFeatures::FixedPoint) != 0>,
+      private sp_detail::ArithmeticSelect<T, (Features & SignalFeatures::FixedPoint) != 0,
+          (Features & SignalFeatures::Ema) != 0, (Features & SignalFeatures::Derivative) != 0,
+          (Features & SignalFeatures::Integral) != 0>::Derivative,
+      private sp_detail::ArithmeticSelect<T, (Features & SignalFeatures::FixedPoint) != 0,
+          (Features & SignalFeatures::Ema) != 0, (Features & SignalFeatures::Derivative) != 0,
+          (Features & SignalFeatures::Integral) != 0>::Integral,
+      private sp_detail::LowpassStage<sp_detail::LowpassSections<Features>::value>,
+      private sp_detail::SlidingDftStage<RingPolicy::kCapacity, sp_detail::SlidingDftBins<Features>::value>,
+      private sp_detail::MedianStage<T, RingPolicy::kCapacity, (Features & SignalFeatures::Median) != 0>,
+      private sp_detail::TriggerStage<sp_detail::TriggerSlots<Features>::value>,
+      private sp_detail::StatsCacheStage<(Features & SignalFeatures::StatsCache) != 0, SignalStats<T> >,
+      private sp_detail::InstrumentationStage<(Features & SignalFeatures::Instrumentation) != 0>
+{
+    // Пара каналів читає суми напряму (AccValue, без округлення до float)
+    template<typename, uint32_t, uint32_t, template<typename> class> friend class SignalProcessorPair;
+
+public:
+    /** Тип лічильника та індексу: uint16_t для N <= 65535, інакше uint32_t */
+    typedef typename RingPolicy::Index SizeType;
+
+    /** Знімок статистики (getStats()) */
+    typedef SignalStats<T> Stats;
+
+    /** Зведення для агрегації між процесорами (summary()) */
+    typedef SignalSummary<T> Summary;
+
+    // Увімкнені стадії (константи часу компіляції)
+    static const bool kHasMean = (Features & (SignalFeatures::Mean | SignalFeatures::Variance)) != 0;
+    static const bool kHasVariance = (Features & SignalFeatures::Variance) != 0;
+    static const bool kHasMinMax = (Features & (SignalFeatures::MinMax | SignalFeatures::MinMaxWedge)) != 0;
+    static const bool kHasEma = (Features & SignalFeatures::Ema) != 0;
+    static const bool kHasDerivative = (Features & SignalFeatures::Derivative) != 0;
+    static const bool kHasIntegral = (Features & SignalFeatures::Integral) != 0;
+    static const bool kHasLowpass = (Features & SignalFeatures::Lowpass) != 0;
+    static const uint8_t kLowpassSections = sp_detail::LowpassSections<Features>::value;
+    static const bool kHasSlidingDft = (Features & SignalFeatures::SlidingDft) != 0;
+    static const uint8_t kDftBins = sp_detail::SlidingDftBins<Features>::value;
+    static const bool kHasMedian = (Features & SignalFeatures::Median) != 0;
+    static const bool kFixedPoint = (Features & SignalFeatures::FixedPoint) != 0;
+    static const bool kHasTriggers = (Features & SignalFeatures::Triggers) != 0;
+    static const uint8_t kTriggerSlots = sp_detail::TriggerSlots<Features>::value;
+    static const bool kInstrumented = (Features & SignalFeatures::Instrumentation) != 0;
+    static const bool kExternalBuffer = (Features & SignalFeatures::ExternalBuffer) != 0;
+
 private:
-    // Циклічний буфер даних
-    T buffer_[N];
-    uint16_t count_;        // Поточна кількість елементів (0 до N)
-    uint16_t index_;        // Індекс для наступного запису (0 до N-1)
-
-    // Базова статистика (онлайн обчислення для ефективності)
-    float sum_;             // Сума всіх значень
-    float sumSq_;           // Сума квадратів
-    T minVal_;              // Мінімальне значення
-    T maxVal_;              // Максимальне значення
-    bool needRecalcMinMax_; // Прапорець для ліниво перерахунку min/max
-
-    // Фільтри
-    float ema_;             // Exponential Moving Average
+    typedef RingPolicy Ring;
+    typedef typename sp_detail::KernelSelect<T, (Ring::kCapacity >= 16)>::type Kernel;
+    typedef Accumulator<T> Acc;
+    typedef typename Acc::Term AccTerm;
+    typedef typename Acc::Value AccValue;
+    typedef typename sp_detail::SumKernelSelect<T, Kernel, AccTerm>::type SumKernel;
 
-    // Похідна та інтегратор (для даних з часовими мітками)
-    T lastValue_;           // Попереднє значення
-    uint32_t lastTimeMs_;   // Попередня часова мітка (мс)
-    uint16_t derivativePeriodMs_; // Період похідної в мс
-    bool useEmaFilteredValueForDerivation_; // Чи використовуємо фільтроване значення для розрахунку похідної
-    float derivative_;      // Похідна (raw)
-    float derivativeFiltered_; // Згладжена похідна
-    float integrator_;      // Накопичений інтеграл
-    float lastIntegrandValue_; // Для трапецоїдального методу
+    typedef typename sp_detail::MinMaxSelect<T, Ring::kCapacity, kHasMinMax,
+        (Features & SignalFeatures::MinMaxWedge) != 0>::type MinMaxTracker;
+    typedef typename sp_detail::ArithmeticSelect<T, kFixedPoint, kHasEma,
+        kHasDerivative, kHasIntegral>::Ema EmaBase;
+    typedef sp_detail::TimeDelta<kFixedPoint> TimeDelta;
 
-    // Параметри фільтрів (можна налаштовувати)
-    float alphaEma_;        // Коефіцієнт EMA (0.0 - 1.0)
-    float alphaDerivFilter_;// Коефіцієнт згладжування похідної
-    float alphaLowpass_;    // Коефіцієнт low-pass фільтра
+    // Стадії, стан яких входить у saveState()
+    typedef sp_detail::SumStage<kHasMean, Acc> SumBase;
+    typedef sp_detail::SumSqStage<kHasVariance, Acc> SumSqBase;
+    typedef sp_detail::TimeStage<kHasDerivative || kHasIntegral, kFixedPoint> TimeBase;
+    typedef typename sp_detail::ArithmeticSelect<T, kFixedPoint, kHasEma,
+        kHasDerivative, kHasIntegral>::Derivative DerivativeBase;
+    typedef typename sp_detail::ArithmeticSelect<T, kFixedPoint, kHasEma,
+        kHasDerivative, kHasIntegral>::Integral IntegralBase;
+    typedef sp_detail::LowpassStage<kLowpassSections> LowpassBase;
+    typedef sp_detail::SlidingDftStage<Ring::kCapacity, kDftBins> DftBase;
+
+    // Довжина FFT computeSpectrum(): для DynRing - заглушка, щоб після static_assert
+    // не інстанціювалися таблиці на kCapacity значень
+    static const uint32_t kSpectrumSize = Ring::kFixed ? Ring::kCapacity : 8;
+
+    static_assert(!kFixedPoint || (sp_detail::IsIntegral<T>::value && sizeof(T) <= 2),
+                  "SignalFeatures::FixedPoint requires an 8/16-bit integral sample type");
+    static_assert(!kFixedPoint || sp_detail::IsIntegral<AccTerm>::value,
+                  "SignalFeatures::FixedPoint requires an integer accumulator (ExactAccumulator)");
+    static_assert(!kFixedPoint || (!kHasLowpass && !kHasSlidingDft),
+                  "SignalFeatures::FixedPoint does not support Lowpass/SlidingDft (use FixedDefault)");
+    static_assert(!kFixedPoint || !kHasTriggers,
+                  "SignalFeatures::Triggers compare in floating point and cannot be combined with FixedPoint");
+
+    // Циклічний буфер даних (вбудований або пам'ять користувача; з DynRing - завжди вказівник)
+    typename sp_detail::BufferStorage<T, Ring::kCapacity, kExternalBuffer || !Ring::kFixed>::Type buffer_;
+    SizeType count_;        // Поточна кількість елементів (0 до N)
+    SizeType index_;        // Індекс для наступного запису (0 до N-1)
+
+    // Статистика, фільтри, похідна та інтегратор - у базових класах-стадіях (sp_detail)
+
+    /** Похідна та інтегратор: крок, якщо передана мітка або задано фіксований період */
+    SP_CONSTEXPR void updateDerivative(T value, uint32_t time, bool stamped) {
+        if (this->timeStep(time, stamped)) {
+            const TimeDelta& d = this->timeDelta();
+            this->derivUpdate(value, EmaBase::emaOr(value), d);
+            this->integralUpdate(value, d);
+        } else if (timed(stamped)) {
+            this->instrDerivativeSkipped();
+        }
+    }
+
+    /** Запит min/max перерахує весь буфер - рахуємо для getCounters() */
+    SP_CONSTEXPR void countMinMaxRescan() const {
+        if (MinMaxTracker::minMaxStale()) this->instrRescan(count_);
+    }
 
     /**
-     * Перерахунок min/max по всьому буферу
-     * Викликається лінива (lazy), тільки коли потрібно і встановлений прапорець
+     * Запис суцільного сегмента в буфер з позиції index_ (без переходу через кінець)
+     * Статистика вікна оновлюється цілим сегментом: віднімаємо витіснені значення, додаємо нові
      */
-    void recalculateMinMax() {
-        if (count_ == 0) {
-            minVal_ = maxVal_ = 0;
-            needRecalcMinMax_ = false;
+    SP_CONSTEXPR void storeSegment(const T* samples, SizeType len) {
+        typename SumKernel::Sum segSum = 0, segSumSq = 0;
+        if (count_ == Ring::capacity()) {
+            if (kHasMean) SumKernel::sums(buffer_ + index_, len, segSum, segSumSq);
+            this->sumSub((AccTerm)segSum);
+            this->sumSqSub((AccTerm)segSumSq);
+            MinMaxTracker::evictBlock(buffer_, index_, len);
+        } else {
+            // Поки буфер не повний, index_ == count_ і сегмент лягає у вільні комірки
+            count_ = (SizeType)(count_ + len);
+        }
+
+        sp_detail::copyValues(&buffer_[index_], samples, len);
+        if (kHasMean) SumKernel::sums(buffer_ + index_, len, segSum, segSumSq);
+        this->sumAdd((AccTerm)segSum);
+        this->sumSqAdd((AccTerm)segSumSq);
+        MinMaxTracker::insertBlock(buffer_, index_, len, count_);
+
+        index_ = Ring::advance(index_, len);
+    }
+
+    /**
+     * Ковзний DFT по блоку (до запису в буфер): вихідне значення для i-го семпла -
+     * ще не перезаписана позиція index_ + i або, при i >= N, семпл самого блоку
+     */
+    SP_CONSTEXPR void dftUpdateBlock(const T* samples, size_t n) {
+        if (!kHasSlidingDft) return;
+        uint32_t count = count_;
+        for (size_t i = 0; i < n; i++) {
+            float outgoing = 0.0f;
+            if (count == Ring::capacity()) {
+                outgoing = (i >= Ring::capacity()) ? (float)samples[i - Ring::capacity()] : (float)buffer_[Ring::advance(index_, (uint32_t)i)];
+            } else {
+                count++;
+            }
+            this->dftUpdate((float)samples[i], outgoing);
+        }
+    }
+
+    /**
+     * Перевірка тригерів після нових значень: Mean і StdDev порівнюються через суми
+     * (sum > level * n, n * sumSq - sum^2 > level^2 * n * (n - 1)) - без ділення і sqrt
+     * @param last Останнє додане значення
+     * @param samples Кількість нових значень
+     */
+    SP_CONSTEXPR void evaluateTriggers(T last, uint32_t samples) {
+        if (this->triggersUsed() == 0) return;
+        for (uint8_t id = 0; id < kTriggerSlots; id++) {
+            switch (this->triggerMetric(id)) {
+            case SignalTrigger::Value:
+                this->triggerStep(id, (AccValue)last, (AccValue)1, samples);
+                break;
+            case SignalTrigger::Mean:
+                this->triggerStep(id, this->sumValue(), (AccValue)count_, samples);
+                break;
+            case SignalTrigger::StdDev: {
+                AccValue n = (AccValue)count_;
+                AccValue s = this->sumValue();
+                AccValue m2 = (count_ > 1) ? n * this->sumSqValue() - s * s : (AccValue)0;
+                this->triggerStep(id, m2, (count_ > 1) ? n * (n - 1) : (AccValue)1, samples);
+                break;
+            }
+            case SignalTrigger::Ema:
+                this->triggerStep(id, (AccValue)EmaBase::emaValue(), (AccValue)1, samples);
+                break;
+            case SignalTrigger::Lowpass:
+                this->triggerStep(id, (AccValue)this->lowpassValue(), (AccValue)1, samples);
+                break;
+            case SignalTrigger::Derivative:
+                this->triggerStep(id, (AccValue)this->derivValue(), (AccValue)1, samples);
+                break;
+            case SignalTrigger::DerivativeFiltered:
+                this->triggerStep(id, (AccValue)this->derivFilteredValue(), (AccValue)1, samples);
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    /** Впорядковане вікно по блоку (до запису в буфер) */
+    SP_CONSTEXPR void medianUpdateBlock(const T* samples, size_t n) {
+        if (!kHasMedian) return;
+        if (n >= Ring::capacity()) {
+            this->medianRebuild(samples + (n - Ring::capacity()), Ring::capacity());
             return;
         }
-        
-        minVal_ = buffer_[0];
-        maxVal_ = buffer_[0];
-        
-        for (uint16_t i = 1; i < count_; i++) {
-            if (buffer_[i] < minVal_) minVal_ = buffer_[i];
-            if (buffer_[i] > maxVal_) maxVal_ = buffer_[i];
+        uint32_t count = count_;
+        for (size_t i = 0; i < n; i++) {
+            if (count == Ring::capacity()) {
+                this->medianReplace(buffer_[Ring::advance(index_, (uint32_t)i)], samples[i]);
+            } else {
+                this->medianInsert(samples[i], count++);
+            }
         }
-        
-        needRecalcMinMax_ = false;
     }
 
-public:
+    /** Min/max і впорядковане вікно заново з вмісту буфера в хронологічному порядку */
+    SP_CONSTEXPR void rebuildWindow() {
+        MinMaxTracker::reset();
+        if (count_ == Ring::capacity()) {
+            MinMaxTracker::insertBlock(buffer_, index_, (SizeType)(Ring::capacity() - index_), (SizeType)(Ring::capacity() - index_));
+            if (index_ > 0) MinMaxTracker::insertBlock(buffer_, 0, index_, count_);
+        } else if (count_ > 0) {
+            MinMaxTracker::insertBlock(buffer_, 0, count_, count_);
+        }
+        this->medianRebuild(buffer_, count_);
+    }
+
+    /** Рекурентні фільтри по сегменту, вже записаному в буфер (commitSamples()) */
+    SP_CONSTEXPR void filterSegment(const T* samples, size_t n, bool firstIsNew) {
+        if (!timed(false)) {
+            this->emaUpdateBlock(samples, n, firstIsNew);
+            this->lowpassUpdateBlock(samples, n, firstIsNew);
+            return;
+        }
+        for (size_t i = 0; i < n; i++) {
+            this->emaUpdate(samples[i], firstIsNew && i == 0);
+            this->lowpassUpdate((float)samples[i], firstIsNew && i == 0);
+            updateDerivative(samples[i], 0, false);
+        }
+    }
+
+    // Знімок стану (saveState() / loadState())
+    static const size_t kStateBlobSize =
+        (kHasMean ? sizeof(SumBase) : 0) + (kHasVariance ? sizeof(SumSqBase) : 0) +
+        (kHasEma ? sizeof(EmaBase) : 0) + ((kHasDerivative || kHasIntegral) ? sizeof(TimeBase) : 0) +
+        (kHasDerivative ? sizeof(DerivativeBase) : 0) + (kHasIntegral ? sizeof(IntegralBase) : 0) +
+        (kHasLowpass ? sizeof(LowpassBase) : 0) + (kHasSlidingDft ? sizeof(DftBase) : 0);
+    static const bool kStatePackable = sp_detail::IsIntegral<T>::value;
+    static const size_t kPackedSampleMax = (8 * sizeof(T) + 7) / 7;   // Varint зигзаг-різниці
+
+    static const uint8_t kStatePacked = 1u << 0;
+
+    static_assert(kStateBlobSize <= 0xFFFFu, "Processor state block does not fit the state header");
+
+    /** Копіювання стану увімкненої стадії в знімок (вимкнена - 0 байт) */
+    template<bool Enabled, typename Stage>
+    static uint8_t* stateWrite(uint8_t* out, const Stage& stage) {
+        if (!Enabled) return out;
+        memcpy(out, &stage, sizeof(Stage));
+        return out + sizeof(Stage);
+    }
+
+    template<bool Enabled, typename Stage>
+    static const uint8_t* stateRead(const uint8_t* in, Stage& stage) {
+        if (!Enabled) return in;
+        memcpy(&stage, in, sizeof(Stage));
+        return in + sizeof(Stage);
+    }
+
+    static void putU32(uint8_t* out, uint32_t v) { memcpy(out, &v, 4); }
+    static void putU16(uint8_t* out, uint16_t v) { memcpy(out, &v, 2); }
+    static uint32_t getU32(const uint8_t* in) { uint32_t v; memcpy(&v, in, 4); return v; }
+    static uint16_t getU16(const uint8_t* in) { uint16_t v; memcpy(&v, in, 2); return v; }
+
+    /** FNV-1a: захист від пошкодженої backup SRAM / flash */
+    static uint32_t stateChecksum(const uint8_t* p, size_t n) {
+        uint32_t h = 2166136261u;
+        for (size_t i = 0; i < n; i++) h = (h ^ p[i]) * 16777619u;
+        return h;
+    }
+
     /**
-     * Конструктор з типовими параметрами фільтрів
+     * Різниці сусідніх значень у зигзаг-кодуванні, varint по 7 біт (для цілих T)
+     * @param out Вихід (0 - тільки підрахунок розміру)
+     * @return Кількість байт
+     */
+    static size_t packSamples(uint8_t* out, const T* src, uint32_t n) {
+        uint64_t prev = 0;
+        size_t size = 0;
+        for (uint32_t i = 0; i < n; i++) {
+            uint64_t v = (uint64_t)(int64_t)src[i];
+            uint64_t d = v - prev;
+            uint64_t z = (d << 1) ^ (uint64_t)((int64_t)d >> 63);
+            prev = v;
+            while (z >= 0x80u) {
+                if (out != 0) out[size] = (uint8_t)(z | 0x80u);
+                size++;
+                z >>= 7;
+            }
+            if (out != 0) out[size] = (uint8_t)z;
+            size++;
+        }
+        return size;
+    }
+
+    /**
+     * Розпакування n значень
+     * @param dst Вихід (0 - тільки перевірка меж)
+     * @return Кінець прочитаних даних; 0, якщо дані виходять за end
      */
-    SignalProcessor()
-        : count_(0), index_(0),
-          sum_(0.0f), sumSq_(0.0f),
-          minVal_(0), maxVal_(0), needRecalcMinMax_(false),
-          ema_(0.0f),
-          lastValue_(0), lastTimeMs_(0),
-          derivative_(0.0f), derivativeFiltered_(0.0f),
-          integrator_(0.0f), lastIntegrandValue_(0.0f),
-          alphaEma_(0.1f), alphaDerivFilter_(0.2f), alphaLowpass_(0.1f)
+    static const uint8_t* unpackSamples(const uint8_t* in, const uint8_t* end, T* dst, uint32_t n) {
+        uint64_t prev = 0;
+        for (uint32_t i = 0; i < n; i++) {
+            uint64_t z = 0;
+            for (uint8_t shift = 0;; shift += 7) {
+                if (in == end || shift >= 64) return 0;
+                uint8_t b = *in++;
+                z |= (uint64_t)(b & 0x7Fu) << shift;
+                if ((b & 0x80u) == 0) break;
+            }
+            prev += (z >> 1) ^ (0 - (z & 1u));
+            if (dst != 0) dst[i] = (T)(int64_t)prev;
+        }
+        return in;
+    }
+
+    /** Чи потрібен крок часу для значень (мітки передані або задано фіксований період) */
+    SP_CONSTEXPR bool timed(bool stamped) const {
+        return (kHasDerivative || kHasIntegral) && (stamped || this->timeSamplePeriod() != 0);
+    }
+
+
+    /** Спільна реалізація add() */
+    SP_CONSTEXPR void addSample(T value, uint32_t time, bool stamped) {
+        const uint32_t t0 = this->instrBegin();
+        this->statsInvalidate();
+        this->instrSamples(1);
+
+        // Якщо буфер повний - видаляємо найстаріше значення зі статистики
+        float outgoing = 0.0f;
+        if (count_ == Ring::capacity()) {
+            AccTerm oldValue = (AccTerm)buffer_[index_];
+            this->sumSub(oldValue);
+            this->sumSqSub(oldValue * oldValue);
+            MinMaxTracker::evict(buffer_, index_);
+            this->medianReplace(buffer_[index_], value);
+            outgoing = (float)buffer_[index_];
+        } else {
+            this->medianInsert(value, count_);
+            count_++;
+        }
+
+        // Зберігаємо нове значення в буфер
+        buffer_[index_] = value;
+        AccTerm term = (AccTerm)value;
+        this->sumAdd(term);
+        this->sumSqAdd(term * term);
+
+        MinMaxTracker::insert(buffer_, index_, count_);
+
+        this->emaUpdate(value, count_ == 1);
+        this->lowpassUpdate((float)value, count_ == 1);
+        this->dftUpdate((float)value, outgoing);
+        updateDerivative(value, time, stamped);
+
+        // Циклічне переміщення індексу (для N = 2^k - маска без розгалуження)
+        index_ = Ring::next(index_);
+
+        evaluateTriggers(value, 1);
+        this->instrEndAdd(t0);
+    }
+
+    /** Спільна реалізація addBlock(): times, або startTime + i * period, якщо stamped */
+    SP_CONSTEXPR void addBlockImpl(const T* samples, size_t n, const uint32_t* times,
+                      uint32_t startTime, uint32_t period, bool stamped) {
+        if (n == 0) return;
+        const uint32_t t0 = this->instrBegin();
+        this->statsInvalidate();
+        this->instrSamples((uint32_t)n);
+        const T last = samples[n - 1];
+        const uint32_t total = (uint32_t)n;
+
+        // Фільтри - рекурентні, тому йдуть окремим проходом по всьому блоку
+        if (!timed(stamped)) {
+            this->emaUpdateBlock(samples, n, count_ == 0);
+            this->lowpassUpdateBlock(samples, n, count_ == 0);
+        } else {
+            uint32_t count = count_;
+            for (size_t i = 0; i < n; i++) {
+                if (count < Ring::capacity()) count++;
+                uint32_t t = (times != 0) ? times[i] : startTime + (uint32_t)i * period;
+                this->emaUpdate(samples[i], count == 1);
+                this->lowpassUpdate((float)samples[i], count == 1);
+                updateDerivative(samples[i], t, stamped);
+            }
+        }
+
+        dftUpdateBlock(samples, n);
+        medianUpdateBlock(samples, n);
+
+        // Блок не менший за вікно повністю замінює вміст буфера
+        if (n >= Ring::capacity()) {
+            samples += n - Ring::capacity();
+            n = Ring::capacity();
+            count_ = 0;
+            index_ = 0;
+            this->sumReset();
+            this->sumSqReset();
+            MinMaxTracker::reset();
+        }
+
+        // Не більше двох суцільних сегментів: до кінця буфера і з початку
+        while (n > 0) {
+            SizeType room = (SizeType)(Ring::capacity() - index_);
+            SizeType len = (n < room) ? (SizeType)n : room;
+            storeSegment(samples, len);
+            samples += len;
+            n -= len;
+        }
+
+        evaluateTriggers(last, total);
+        this->instrEndBlock(t0);
+    }
+
+protected:
+    /** Ядро з вбудованим буфером T[N] */
+    SP_CONSTEXPR SignalProcessorCore()
+        : count_(0), index_(0)
     {}
 
+    /** Ядро над пам'яттю користувача (ExternalBuffer, DynRing); storage може бути 0 до attachStorage() */
+    explicit SP_CONSTEXPR SignalProcessorCore(T* storage)
+        : buffer_(storage), count_(0), index_(0)
+    {}
+
+    /** Новий буфер і ємність (DynRing): вікно порожнє, налаштування стадій лишаються */
+    SP_CONSTEXPR void attachStorage(T* storage, uint32_t capacity) {
+        buffer_ = storage;
+        Ring::resize(capacity);
+        reset();
+    }
+
+public:
+
     // ========================================
     // НАЛАШТУВАННЯ ПАРАМЕТРІВ
     // ========================================
@@ -112,141 +3071,384 @@ public:
      * Встановлення коефіцієнта EMA
      * @param alpha Коефіцієнт (0.0 - 1.0). Більше значення = швидша реакція
      */
-    void setEmaAlpha(float alpha) { 
-        alphaEma_ = (alpha < 0.0f) ? 0.0f : (alpha > 1.0f) ? 1.0f : alpha;
+    SP_CONSTEXPR void setEmaAlpha(float alpha) { 
+        static_assert(kHasEma, "SignalFeatures::Ema is disabled");
+        this->emaSetAlpha((alpha < 0.0f) ? 0.0f : (alpha > 1.0f) ? 1.0f : alpha);
+    }
+
+    /**
+     * Мінімальний інтервал між кроками похідної/інтегратора
+     * @param period Інтервал у тіках setTimeBase() (типово мс); крок, коли інтервал більший
+     */
+    SP_CONSTEXPR void setDerivativePeriodMs(uint32_t period)
+    {
+        static_assert(kHasDerivative || kHasIntegral, "SignalFeatures::Derivative/Integral are disabled");
+    	this->derivativePeriodMs_ = period;
+    }
+
+    /**
+     * Часова база міток: кількість тіків за секунду
+     * @param ticksPerSecond 1000 - мілісекунди (типово), 1000000 - мікросекунди, частота таймера
+     */
+    SP_CONSTEXPR void setTimeBase(uint32_t ticksPerSecond)
+    {
+        static_assert(kHasDerivative || kHasIntegral, "SignalFeatures::Derivative/Integral are disabled");
+        this->ticksPerSecond_ = (ticksPerSecond > 0) ? ticksPerSecond : 1;
+        this->delta_.ticks = 0;
+    }
+
+    /**
+     * Фіксований період дискретизації: кожне значення - крок periodTicks тіків,
+     * мітки не потрібні (передані мітки ігноруються), 1/dt рахується один раз
+     * @param periodTicks Період у тіках setTimeBase(); 0 - інтервал за мітками (типово)
+     */
+    SP_CONSTEXPR void setSamplePeriod(uint32_t periodTicks)
+    {
+        static_assert(kHasDerivative || kHasIntegral, "SignalFeatures::Derivative/Integral are disabled");
+        this->samplePeriod_ = periodTicks;
+        this->pendingTicks_ = 0;
+        this->delta_.ticks = 0;
+    }
+
+    SP_CONSTEXPR void setIsEmaUseForDerivative(bool isEmaUse)
+    {
+        static_assert(kHasDerivative, "SignalFeatures::Derivative is disabled");
+    	this->useEmaFilteredValueForDerivation_ = isEmaUse;
+    }
+
+    /**
+     * Встановлення коефіцієнта згладжування похідної
+     * @param alpha Коефіцієнт (0.0 - 1.0)
+     */
+    SP_CONSTEXPR void setDerivativeFilterAlpha(float alpha) { 
+        static_assert(kHasDerivative, "SignalFeatures::Derivative is disabled");
+        this->derivSetAlpha((alpha < 0.0f) ? 0.0f : (alpha > 1.0f) ? 1.0f : alpha);
+    }
+
+    /**
+     * Встановлення коефіцієнта low-pass фільтра
+     * @param alpha Коефіцієнт (0.0 - 1.0). Менше значення = сильніше згладжування
+     */
+    SP_CONSTEXPR void setLowpassAlpha(float alpha) { 
+        static_assert(kHasLowpass, "SignalFeatures::Lowpass is disabled");
+        alpha = (alpha < 0.0f) ? 0.0f : (alpha > 1.0f) ? 1.0f : alpha;
+        this->lpCoeffs_[0] = BiquadCoeffs::firstOrderLowpass(alpha);
+        for (uint8_t k = 1; k < kLowpassSections; k++) this->lpCoeffs_[k] = BiquadCoeffs::identity();
+    }
+
+    /**
+     * Встановлення коефіцієнтів усіх секцій IIR-фільтра (наприклад, з Butterworth::lowpass())
+     * Стан фільтра зберігається; для старту без перехідного процесу викличте reset()
+     * @param coeffs Масив із kLowpassSections секцій
+     */
+    SP_CONSTEXPR void setLowpass(const BiquadCoeffs* coeffs) {
+        static_assert(kHasLowpass, "SignalFeatures::Lowpass is disabled");
+        for (uint8_t k = 0; k < kLowpassSections; k++) this->lpCoeffs_[k] = coeffs[k];
+    }
+
+    /**
+     * Частота біна ковзного DFT
+     * @param bin Номер біна (0 до kDftBins - 1)
+     * @param freqHz Частота, Гц (не обов'язково кратна fs / N)
+     * @param sampleRateHz Частота дискретизації, Гц
+     */
+    SP_CONSTEXPR void setDftFrequency(uint8_t bin, float freqHz, float sampleRateHz) {
+        setDftBin(bin, freqHz * (float)Ring::capacity() / sampleRateHz);
+    }
+
+    /**
+     * Частота біна ковзного DFT у періодах на вікно N
+     * Стан бінів скидається - нове значення стає коректним після заповнення вікна
+     */
+    SP_CONSTEXPR void setDftBin(uint8_t bin, float cyclesPerWindow) {
+        static_assert(kHasSlidingDft, "SignalFeatures::SlidingDft is disabled");
+        if (bin >= kDftBins) return;
+        this->dftSetBin(bin, cyclesPerWindow);
+        this->dftRe_[bin] = this->dftIm_[bin] = 0.0f;
+    }
+
+    /**
+     * Встановлення коефіцієнтів однієї секції
+     * @param section Номер секції (0 до kLowpassSections - 1)
+     */
+    SP_CONSTEXPR void setLowpassSection(uint8_t section, const BiquadCoeffs& coeffs) {
+        static_assert(kHasLowpass, "SignalFeatures::Lowpass is disabled");
+        if (section < kLowpassSections) this->lpCoeffs_[section] = coeffs;
     }
 
-    void setDerivativePeriodMs(uint16_t period)
-    {
-    	derivativePeriodMs_ = period;
-    }
+    // ========================================
+    // ДОДАВАННЯ ДАНИХ
+    // ========================================
+
+    /**
+     * Додавання нового значення до буфера без часової мітки
+     * Похідна/інтегратор оновлюються тільки з фіксованим періодом (setSamplePeriod())
+     * @param value Нове значення
+     */
+    SP_CONSTEXPR void add(T value) {
+        addSample(value, 0, false);
+    }
+
+    /**
+     * Додавання нового значення з часовою міткою (для похідної/інтегралу)
+     * @param value Нове значення
+     * @param time Часова мітка в тіках setTimeBase() (типово мс); 0 - звичайна мітка,
+     *             перехід лічильника через 0xFFFFFFFF обробляється коректно
+     */
+    SP_CONSTEXPR void add(T value, uint32_t time) {
+        addSample(value, time, true);
+    }
+
+    /**
+     * Пакетне додавання блоку значень без часових міток (наприклад, половина DMA-буфера АЦП)
+     * Результат такий самий, як у послідовних викликів add(), але статистика
+     * оновлюється суцільними сегментами (не більше двох memcpy при n <= N)
+     * @param samples Масив значень
+     * @param n Кількість значень
+     */
+    SP_CONSTEXPR void addBlock(const T* samples, size_t n) {
+        addBlockImpl(samples, n, 0, 0, 0, false);
+    }
+
+    /**
+     * Пакетне додавання блоку значень з рівномірними часовими мітками
+     * @param samples Масив значень
+     * @param n Кількість значень
+     * @param startTime Часова мітка першого значення в тіках
+     * @param period Період дискретизації: мітка i-го значення = startTime + i * period
+     */
+    SP_CONSTEXPR void addBlock(const T* samples, size_t n, uint32_t startTime, uint32_t period) {
+        addBlockImpl(samples, n, 0, startTime, period, true);
+    }
+
+    /**
+     * Пакетне додавання блоку значень з паралельним масивом часових міток
+     * @param samples Масив значень
+     * @param n Кількість значень
+     * @param times Часові мітки в тіках (n елементів)
+     */
+    SP_CONSTEXPR void addBlock(const T* samples, size_t n, const uint32_t* times) {
+        addBlockImpl(samples, n, times, 0, 0, true);
+    }
+
+    /**
+     * Облік значень, які записало в буфер саме обладнання (DMA), без копіювання
+     * Нові значення - n позицій буфера від getWriteIndex() (з переходом через кінець).
+     * Витіснені значення DMA вже перезаписало, тому суми, min/max, медіана і біни
+     * DFT перераховуються по всьому вікну: O(N) (медіана - O(N log N)) незалежно
+     * від n. Тому викликати варто рідко, великими порціями - з переривань
+     * половини та кінця передачі (n = N / 2), як addBlock() з половиною DMA-буфера.
+     * EMA, IIR, похідна (з setSamplePeriod()) та інтегратор проходять лише нові значення.
+     * На Cortex-M7 з D-кешем перед викликом інвалідуйте область (SCB_InvalidateDCache_by_Addr)
+     * або розмістіть буфер у некешованій пам'яті (DTCM).
+     * @param n Кількість нових значень; більше за N - старші вже втрачені, враховуються останні N
+     */
+    SP_CONSTEXPR void commitSamples(size_t n) {
+        static_assert(kExternalBuffer, "SignalFeatures::ExternalBuffer is disabled");
+        if (n == 0) return;
+        const uint32_t t0 = this->instrBegin();
+        this->statsInvalidate();
+        this->instrSamples((uint32_t)n);
+        const uint32_t total = (uint32_t)n;
+        if (n > Ring::capacity()) {
+            index_ = Ring::advance(index_, (uint32_t)(n % Ring::capacity()));
+            n = Ring::capacity();
+        }
+
+        // Не більше двох суцільних сегментів: до кінця буфера і з початку
+        SizeType room = (SizeType)(Ring::capacity() - index_);
+        SizeType head = (n < room) ? (SizeType)n : room;
+        filterSegment(buffer_ + index_, head, count_ == 0);
+        if (n > head) filterSegment(buffer_, n - head, false);
+
+        const T last = buffer_[Ring::advance(index_, (uint32_t)(n - 1))];
+        count_ = (count_ + n < Ring::capacity()) ? (SizeType)(count_ + n) : (SizeType)Ring::capacity();
+        index_ = Ring::advance(index_, (uint32_t)n);
+
+        recalculateSums();
+        rebuildWindow();
 
-    void setIsEmaUseForDerivative(bool isEmaUse)
-    {
-    	useEmaFilteredValueForDerivation_ = isEmaUse;
+        evaluateTriggers(last, total);
+        this->instrEndBlock(t0);
     }
 
     /**
-     * Встановлення коефіцієнта згладжування похідної
-     * @param alpha Коефіцієнт (0.0 - 1.0)
+     * Облік значень DMA за позицією запису обладнання
+     * Для STM32 у циклічному режимі: writeIndex = N - __HAL_DMA_GET_COUNTER(hdma)
+     * Нових значень (writeIndex - позиція запису) mod N; повний оберт між викликами
+     * не відрізнити від нуля - викликайте частіше, ніж раз на N значень
+     * @param writeIndex Індекс наступного запису DMA (0 до N-1); більший - ігнорується
      */
-    void setDerivativeFilterAlpha(float alpha) { 
-        alphaDerivFilter_ = (alpha < 0.0f) ? 0.0f : (alpha > 1.0f) ? 1.0f : alpha;
+    SP_CONSTEXPR void syncWriteIndex(uint32_t writeIndex) {
+        static_assert(kExternalBuffer, "SignalFeatures::ExternalBuffer is disabled");
+        if (writeIndex >= Ring::capacity()) return;
+        commitSamples((writeIndex >= index_) ? writeIndex - index_ : writeIndex + Ring::capacity() - index_);
     }
 
     /**
-     * Встановлення коефіцієнта low-pass фільтра
-     * @param alpha Коефіцієнт (0.0 - 1.0). Менше значення = сильніше згладжування
+     * Повне скидання всіх даних та статистики
      */
-    void setLowpassAlpha(float alpha) { 
-        alphaLowpass_ = (alpha < 0.0f) ? 0.0f : (alpha > 1.0f) ? 1.0f : alpha;
+    SP_CONSTEXPR void reset() {
+        count_ = 0;
+        index_ = 0;
+        this->sumReset();
+        this->sumSqReset();
+        MinMaxTracker::reset();
+        this->emaReset();
+        this->lowpassReset();
+        this->dftReset();
+        this->derivReset();
+        this->timeReset();
+        this->integralReset();
+        this->triggersReset();
+        this->statsInvalidate();
     }
 
-    // ========================================
-    // ДОДАВАННЯ ДАНИХ
-    // ========================================
-
     /**
-     * Додавання нового значення до буфера
-     * @param value Нове значення
-     * @param timeMs Часова мітка в мілісекундах (опціонально, для похідної/інтегралу)
+     * Перерахунок суми та суми квадратів по всьому буферу (векторні ядра)
+     * Усуває похибку, накопичену FloatAccumulator за мільйони додавань/віднімань.
+     * З KahanAccumulator/DoubleAccumulator/ExactAccumulator зазвичай не потрібен.
+     * З SignalFeatures::SlidingDft також точно перераховує біни DFT (O(N * K))
      */
-    void add(T value, uint32_t timeMs = 0) {
-        // Якщо буфер повний - видаляємо найстаріше значення зі статистики
-        if (count_ == N) {
-            T oldValue = buffer_[index_];
-            sum_ -= (float)oldValue;
-            sumSq_ -= (float)oldValue * (float)oldValue;
-            
-            // Якщо видаляємо min або max - позначаємо, що потрібен перерахунок
-            if (oldValue == minVal_ || oldValue == maxVal_) {
-                needRecalcMinMax_ = true;
-            }
+    SP_CONSTEXPR void recalculateSums() {
+        typename SumKernel::Sum s = 0, sq = 0;
+        if (kHasMean && count_ > 0) SumKernel::sums(buffer_, count_, s, sq);
+        this->sumReset();
+        this->sumAdd((AccTerm)s);
+        this->sumSqReset();
+        this->sumSqAdd((AccTerm)sq);
+        if (count_ == Ring::capacity()) {
+            this->dftResync(buffer_ + index_, Ring::capacity() - index_, buffer_, index_);
         } else {
-            count_++;
+            this->dftResync(buffer_, count_, buffer_, 0);
         }
+        this->statsInvalidate();
+    }
 
-        // Зберігаємо нове значення в буфер
-        buffer_[index_] = value;
-        sum_ += (float)value;
-        sumSq_ += (float)value * (float)value;
+    // ========================================
+    // ЗБЕРЕЖЕННЯ СТАНУ (теплий перезапуск)
+    // ========================================
 
-        // Оновлення min/max (швидке, якщо не потрібен повний перерахунок)
-        if (count_ == 1) {
-            minVal_ = maxVal_ = value;
-            needRecalcMinMax_ = false;
-        } else if (!needRecalcMinMax_) {
-            if (value < minVal_) minVal_ = value;
-            if (value > maxVal_) maxVal_ = value;
-        }
+    /** Версія формату saveState() */
+    static const uint8_t kStateVersion = 1;
 
-        // Оновлення EMA фільтра
-        if (count_ == 1) {
-            ema_ = (float)value;
-        } else {
-            ema_ = alphaEma_ * (float)value + (1.0f - alphaEma_) * ema_;
-        }
+    /** Розмір заголовка знімка, байт */
+    static const size_t kStateHeaderSize = 32;
 
-        // Похідна та інтегратор (якщо передані часові мітки)
-        if (timeMs > 0 && (timeMs - lastTimeMs_ > derivativePeriodMs_)) {
-            float dt = (float)(timeMs - lastTimeMs_) * 0.001f;  // секунди
-            
-            int val = useEmaFilteredValueForDerivation_ ? ema_ : value;
-            // Сира похідна
-            float rawDerivative = (float) ((int)val - lastValue_) / dt;
-            derivative_ = rawDerivative;
-            
-            // Згладжена похідна (EMA)
-            if (count_ <= 2) {
-                derivativeFiltered_ = rawDerivative;
-            } else {
-                derivativeFiltered_ = alphaDerivFilter_ * rawDerivative + (1.0f - alphaDerivFilter_) * derivativeFiltered_;
-            }
-            
-            // Інтегратор (трапецоїдальний метод для точності)
-            if (count_ > 1) {
-                integrator_ += 0.5f * (lastIntegrandValue_ + (float)value) * dt;
-            }
-            lastIntegrandValue_ = (float)value;
+    /** Достатній розмір буфера для saveState() з будь-яким packed (у SignalProcessorDyn - без вікна, див. getStateSize()) */
+    static const size_t kMaxStateSize = kStateHeaderSize + kStateBlobSize +
+        (Ring::kFixed ? Ring::kCapacity : 0) *
+        ((kStatePackable && kPackedSampleMax > sizeof(T)) ? kPackedSampleMax : sizeof(T));
 
-            if (timeMs > 0) lastTimeMs_ = timeMs;
-            // Оновлення стану
-            lastValue_ = val;
+    /**
+     * Знімок стану для теплого перезапуску (backup SRAM, flash)
+     * Вміст вікна, акумулятори, EMA, похідна, інтегратор, IIR і DFT разом з їхніми
+     * налаштуваннями. Тригери (вказівники на callback-и) та лічильники не зберігаються.
+     * Багатобайтові поля - у порядку байтів платформи.
+     * @param out Буфер щонайменше kMaxStateSize байт (або getStateSize(packed))
+     * @param packed Для цілих T - різниці сусідніх значень varint (повільний сигнал 12-бітного
+     *               АЦП - 1-2 байти на значення); для float ігнорується
+     * @return Кількість записаних байт
+     */
+    size_t saveState(uint8_t* out, bool packed = false) const {
+        packed = packed && kStatePackable;
+        uint8_t* p = out + kStateHeaderSize;
+        p = stateWrite<kHasMean>(p, static_cast<const SumBase&>(*this));
+        p = stateWrite<kHasVariance>(p, static_cast<const SumSqBase&>(*this));
+        p = stateWrite<kHasEma>(p, static_cast<const EmaBase&>(*this));
+        p = stateWrite<kHasDerivative || kHasIntegral>(p, static_cast<const TimeBase&>(*this));
+        p = stateWrite<kHasDerivative>(p, static_cast<const DerivativeBase&>(*this));
+        p = stateWrite<kHasIntegral>(p, static_cast<const IntegralBase&>(*this));
+        p = stateWrite<kHasLowpass>(p, static_cast<const LowpassBase&>(*this));
+        p = stateWrite<kHasSlidingDft>(p, static_cast<const DftBase&>(*this));
+        if (packed) {
+            p += packSamples(p, buffer_, count_);
+        } else {
+            memcpy(p, buffer_, count_ * sizeof(T));
+            p += count_ * sizeof(T);
         }
 
-
-        
-
-        // Циклічне переміщення індексу
-        index_++;
-        if (index_ >= N) index_ = 0;
+        uint32_t payload = (uint32_t)(p - (out + kStateHeaderSize));
+        out[0] = 'S';
+        out[1] = 'P';
+        out[2] = kStateVersion;
+        out[3] = packed ? kStatePacked : 0;
+        putU32(out + 4, Features);
+        putU32(out + 8, Ring::capacity());
+        putU32(out + 12, count_);
+        putU32(out + 16, index_);
+        putU16(out + 20, (uint16_t)sizeof(T));
+        putU16(out + 22, (uint16_t)kStateBlobSize);
+        putU32(out + 24, payload);
+        putU32(out + 28, stateChecksum(out + kStateHeaderSize, payload));
+        return kStateHeaderSize + payload;
     }
 
     /**
-     * Оператор += для зручного додавання
+     * Точний розмір знімка (з packed - прохід по вікну, O(N))
      */
-    SignalProcessor& operator+=(T value) {
-        add(value, 0);
-        return *this;
+    size_t getStateSize(bool packed = false) const {
+        size_t samples = (packed && kStatePackable) ? packSamples(0, buffer_, count_) : count_ * sizeof(T);
+        return kStateHeaderSize + kStateBlobSize + samples;
     }
 
     /**
-     * Повне скидання всіх даних та статистики
+     * Відновлення стану зі знімка saveState()
+     * Акумулятори та фільтри відновлюються копіюванням (O(1)), min/max і медіана
+     * перебудовуються з вікна. Перша мітка після відновлення - нова точка відліку часу
+     * (лічильник міток після перезапуску МК почався заново). Тригери лишаються
+     * зареєстрованими зі скинутим станом.
+     * @param in Знімок
+     * @param size Розмір знімка, байт
+     * @return false, якщо знімок пошкоджений або від іншої конфігурації (стан не змінюється)
      */
-    void reset() {
-        count_ = 0;
-        index_ = 0;
-        sum_ = 0.0f;
-        sumSq_ = 0.0f;
-        minVal_ = maxVal_ = 0;
-        needRecalcMinMax_ = false;
-        ema_ = 0.0f;
-        lastValue_ = 0;
-        lastTimeMs_ = 0;
-        derivative_ = 0.0f;
-        derivativeFiltered_ = 0.0f;
-        integrator_ = 0.0f;
-        lastIntegrandValue_ = 0.0f;
+    bool loadState(const uint8_t* in, size_t size) {
+        if (size < kStateHeaderSize) return false;
+        if (in[0] != 'S' || in[1] != 'P' || in[2] != kStateVersion) return false;
+        if ((in[3] & ~kStatePacked) != 0) return false;
+        const bool packed = (in[3] & kStatePacked) != 0;
+        const uint32_t count = getU32(in + 12);
+        const uint32_t index = getU32(in + 16);
+        const uint32_t payload = getU32(in + 24);
+        if (getU32(in + 4) != Features || getU32(in + 8) != Ring::capacity() ||
+            getU16(in + 20) != sizeof(T) || getU16(in + 22) != kStateBlobSize) return false;
+        if (count > Ring::capacity() || (count < Ring::capacity() && index != count) || index >= Ring::capacity()) return false;
+        if (packed && !kStatePackable) return false;
+        if (payload > size - kStateHeaderSize || payload < kStateBlobSize) return false;
+        if (!packed && payload != kStateBlobSize + count * sizeof(T)) return false;
+        const uint8_t* p = in + kStateHeaderSize;
+        if (stateChecksum(p, payload) != getU32(in + 28)) return false;
+
+        const uint8_t* end = p + payload;
+        const uint8_t* samples = p + kStateBlobSize;
+        // Межі varint - окремим проходом до запису: на false вікно лишається цілим
+        if (packed && unpackSamples(samples, end, 0, count) != end) return false;
+
+        if (packed) {
+            unpackSamples(samples, end, buffer_, count);
+        } else {
+            memcpy(buffer_, samples, count * sizeof(T));
+        }
+
+        p = stateRead<kHasMean>(p, static_cast<SumBase&>(*this));
+        p = stateRead<kHasVariance>(p, static_cast<SumSqBase&>(*this));
+        p = stateRead<kHasEma>(p, static_cast<EmaBase&>(*this));
+        p = stateRead<kHasDerivative || kHasIntegral>(p, static_cast<TimeBase&>(*this));
+        p = stateRead<kHasDerivative>(p, static_cast<DerivativeBase&>(*this));
+        p = stateRead<kHasIntegral>(p, static_cast<IntegralBase&>(*this));
+        p = stateRead<kHasLowpass>(p, static_cast<LowpassBase&>(*this));
+        p = stateRead<kHasSlidingDft>(p, static_cast<DftBase&>(*this));
+
+        count_ = (SizeType)count;
+        index_ = (SizeType)((count < Ring::capacity()) ? count : index);
+
+        // Похідні структури - з вмісту вікна в хронологічному порядку
+        rebuildWindow();
+
+        this->timeRestart();
+        this->triggersReset();
+        this->statsInvalidate();
+        return true;
     }
 
     // ========================================
@@ -254,51 +3456,150 @@ public:
     // ========================================
 
     /** Кількість значень у буфері (0 до N) */
-    uint16_t getCount() const { return count_; }
+    SP_CONSTEXPR SizeType getCount() const { return count_; }
 
     /** Сума всіх значень */
-    float getSum() const { return sum_; }
+    SP_CONSTEXPR float getSum() const {
+        static_assert(kHasMean, "SignalFeatures::Mean is disabled");
+        return (float)this->sum_.value();
+    }
 
     /** Середнє арифметичне */
-    float getMean() const { 
-        return (count_ > 0) ? (sum_ / (float)count_) : 0.0f; 
+    SP_CONSTEXPR float getMean() const { 
+        static_assert(kHasMean, "SignalFeatures::Mean is disabled");
+        return (count_ > 0) ? (float)(this->sum_.value() / (AccValue)count_) : 0.0f; 
     }
 
     /** Sample variance (незміщена оцінка дисперсії) */
-    float getVariance() const {
+    SP_CONSTEXPR float getVariance() const {
+        static_assert(kHasVariance, "SignalFeatures::Variance is disabled");
         if (count_ <= 1) return 0.0f;
-        float mean = getMean();
-        return (sumSq_ - (float)count_ * mean * mean) / (float)(count_ - 1);
+        AccValue mean = this->sum_.value() / (AccValue)count_;
+        AccValue var = (this->sumSq_.value() - (AccValue)count_ * mean * mean) / (AccValue)(count_ - 1);
+        // Залишкова похибка округлення не повинна давати від'ємну дисперсію (і NaN у getStdDev)
+        return (var > 0) ? (float)var : 0.0f;
     }
 
     /** Стандартне відхилення (корінь з дисперсії) */
-    float getStdDev() const { 
-        return sqrtf(getVariance()); 
+    SP_CONSTEXPR float getStdDev() const { 
+        return sp_detail::mathSqrt(getVariance());
     }
 
     /** Коефіцієнт варіації (CV) - відносна мінливість у відсотках */
-    float getCoefficientOfVariation() const {
+    SP_CONSTEXPR float getCoefficientOfVariation() const {
         float mean = getMean();
         if (mean == 0.0f) return 0.0f;
         return (getStdDev() / mean) * 100.0f;
     }
 
+    /** Енергія вікна: сума квадратів значень */
+    SP_CONSTEXPR float getEnergy() const {
+        static_assert(kHasVariance, "SignalFeatures::Variance is disabled");
+        return (float)this->sumSqValue();
+    }
+
+    /** Середній квадрат (потужність на одиничному навантаженні) */
+    SP_CONSTEXPR float getMeanSquare() const {
+        static_assert(kHasVariance, "SignalFeatures::Variance is disabled");
+        if (count_ == 0) return 0.0f;
+        AccValue ms = this->sumSqValue() / (AccValue)count_;
+        // Дрейф FloatAccumulator не повинен давати від'ємне значення (і NaN у getRms)
+        return (ms > 0) ? (float)ms : 0.0f;
+    }
+
+    /**
+     * Середньоквадратичне значення (RMS) з суми квадратів
+     * Корінь рахується при запиті, а з SignalFeatures::StatsCache - один раз до наступного add()
+     */
+    SP_CONSTEXPR float getRms() const {
+        float rms = 0.0f;
+        if (this->rmsLoad(rms)) return rms;
+        rms = sp_detail::mathSqrt(getMeanSquare());
+        this->rmsStore(rms);
+        return rms;
+    }
+
     /** Мінімальне значення у буфері */
-    T getMin() {
-        if (needRecalcMinMax_) recalculateMinMax();
-        return minVal_;
+    SP_CONSTEXPR T getMin() const {
+        static_assert(kHasMinMax, "SignalFeatures::MinMax is disabled");
+        countMinMaxRescan();
+        return MinMaxTracker::min(buffer_, count_);
     }
 
     /** Максимальне значення у буфері */
-    T getMax() {
-        if (needRecalcMinMax_) recalculateMinMax();
-        return maxVal_;
+    SP_CONSTEXPR T getMax() const {
+        static_assert(kHasMinMax, "SignalFeatures::MinMax is disabled");
+        countMinMaxRescan();
+        return MinMaxTracker::max(buffer_, count_);
     }
 
     /** Розмах (різниця між max і min) */
-    float getRange() {
-        if (needRecalcMinMax_) recalculateMinMax();
-        return (float)(maxVal_ - minVal_);
+    SP_CONSTEXPR float getRange() const {
+        return (float)(getMax() - getMin());
+    }
+
+    /** Пік-фактор: max(|min|, |max|) / RMS (0 для порожнього або нульового вікна) */
+    SP_CONSTEXPR float getCrestFactor() const {
+        static_assert(kHasVariance && kHasMinMax, "getCrestFactor() needs SignalFeatures::Variance and MinMax");
+        float rms = getRms();
+        if (rms <= 0.0f) return 0.0f;
+        T lo = 0, hi = 0;
+        countMinMaxRescan();
+        MinMaxTracker::minMax(buffer_, count_, lo, hi);
+        float peak = ((float)hi > -(float)lo) ? (float)hi : -(float)lo;
+        return peak / rms;
+    }
+
+    /**
+     * Узгоджений знімок статистики за один прохід: одна дисперсія, один sqrt,
+     * один запит min/max. Поля вимкнених стадій - 0.
+     * З SignalFeatures::StatsCache повторні виклики до наступного add() повертають
+     * кешований знімок без обчислень
+     */
+    SP_CONSTEXPR Stats getStats() const {
+        Stats s;
+        if (this->statsLoad(s)) return s;
+
+        s.count = count_;
+        s.mean = s.variance = s.stdDev = s.cv = s.range = s.ema = 0.0f;
+        s.min = s.max = 0;
+
+        if (kHasMean && count_ > 0) {
+            AccValue mean = this->sumValue() / (AccValue)count_;
+            s.mean = (float)mean;
+            if (kHasVariance && count_ > 1) {
+                AccValue var = (this->sumSqValue() - (AccValue)count_ * mean * mean) / (AccValue)(count_ - 1);
+                s.variance = (var > 0) ? (float)var : 0.0f;
+                s.stdDev = sp_detail::mathSqrt(s.variance);
+                if (s.mean != 0.0f) s.cv = (s.stdDev / s.mean) * 100.0f;
+            }
+        }
+        if (kHasMinMax && count_ > 0) {
+            countMinMaxRescan();
+            MinMaxTracker::minMax(buffer_, count_, s.min, s.max);
+            s.range = (float)(s.max - s.min);
+        }
+        s.ema = EmaBase::emaValue();
+
+        this->statsStore(s);
+        return s;
+    }
+
+    /**
+     * Зведення вікна для агрегації (Summary::combine()), O(1) з акумуляторів
+     * (з лінивим min/max - можливий один перерахунок після витіснення екстремуму)
+     *
+     *   SignalSummary<int16_t> total;
+     *   for (k = 0; k < 3; k++) total.merge(phase[k].summary());
+     *   double fleetStdDev = total.stdDev();
+     */
+    SP_CONSTEXPR Summary summary() const {
+        static_assert(kHasVariance && kHasMinMax, "summary() needs SignalFeatures::Variance and MinMax");
+        if (count_ == 0) return Summary();
+        T lo, hi;
+        countMinMaxRescan();
+        MinMaxTracker::minMax(buffer_, count_, lo, hi);
+        return Summary::fromSums(count_, (double)this->sumValue(), (double)this->sumSqValue(), lo, hi);
     }
 
     // ========================================
@@ -306,28 +3607,144 @@ public:
     // ========================================
 
     /** Exponential Moving Average */
-    float getEma() const { return ema_; }
+    SP_CONSTEXPR float getEma() const {
+        static_assert(kHasEma, "SignalFeatures::Ema is disabled");
+        return EmaBase::emaValue();
+    }
 
     /** Simple Moving Average (те саме що getMean) */
-    float getSma() const { return getMean(); }
+    SP_CONSTEXPR float getSma() const { return getMean(); }
+
+    /**
+     * Вихід FIR-фільтра над останніми Fir::kLength значеннями буфера
+     * Вікно читається двома суцільними сегментами кільця; поки значень менше за
+     * довжину фільтра, відсутні вважаються нулями
+     * @param lag Зсув вікна в минуле: 0 - вихід для останнього значення
+     */
+    template<class Fir>
+    typename Fir::Output getFir(SizeType lag = 0) const {
+        static_assert(Ring::kFixed, "getFir() needs a compile-time window (SignalProcessor)");
+        static_assert(Fir::kLength <= Ring::kCapacity, "FIR is longer than the buffer");
+        if (lag >= count_) return Fir::output(0);
+
+        uint32_t avail = (uint32_t)count_ - lag;
+        uint32_t len = (avail < Fir::kLength) ? avail : Fir::kLength;
+        uint32_t first = Fir::kLength - len;            // Коефіцієнти для відсутніх значень
+        uint32_t end = Ring::advance(index_, Ring::capacity() - lag);  // Позиція після найновішого значення вікна
+
+        if (end >= len) {
+            return Fir::output(Fir::mac(buffer_ + end - len, first, len));
+        }
+        uint32_t tail = len - end;                      // Частина вікна в кінці буфера
+        return Fir::output(Fir::mac(buffer_ + Ring::capacity() - tail, first, tail) +
+                           Fir::mac(buffer_, first + tail, end));
+    }
+
+    /**
+     * Децимація на M: FIR обчислюється тільки для значень, що залишаються
+     * (K MAC на вихід, тобто K / M на вхідне значення - як у поліфазній схемі)
+     * Викликати після add()/addBlock() з newSamples <= N - Fir::kLength + 1
+     * @param m Коефіцієнт децимації
+     * @param newSamples Кількість значень, доданих після попереднього виклику
+     * @param phase Фаза дециматора між викликами (0 - наступне значення дає вихід)
+     * @param out Масив виходів (не менше newSamples / m + 1)
+     * @return Кількість записаних виходів
+     */
+    template<class Fir>
+    SizeType firDecimate(uint32_t m, SizeType newSamples, uint32_t& phase,
+                         typename Fir::Output* out) const {
+        SizeType produced = 0;
+        if (newSamples > count_) newSamples = count_;
+        for (SizeType i = 0; i < newSamples; i++) {
+            if (phase == 0) out[produced++] = getFir<Fir>((SizeType)(newSamples - 1 - i));
+            phase = (phase + 1 >= m) ? 0 : phase + 1;
+        }
+        return produced;
+    }
+
+    /**
+     * Амплітуда синусоїди на частоті біна: 2 * |S| / count
+     * Частота, не кратна fs / N, дає розтікання спектра (як у DFT з прямокутним вікном)
+     */
+    SP_CONSTEXPR float getDftMagnitude(uint8_t bin) const {
+        static_assert(kHasSlidingDft, "SignalFeatures::SlidingDft is disabled");
+        if (count_ == 0 || bin >= kDftBins) return 0.0f;
+        float re = this->dftRe_[bin], im = this->dftIm_[bin];
+        return 2.0f * sp_detail::mathSqrt(re * re + im * im) / (float)count_;
+    }
+
+    /** Фаза біна в радіанах відносно найновішого значення */
+    float getDftPhase(uint8_t bin) const {
+        static_assert(kHasSlidingDft, "SignalFeatures::SlidingDft is disabled");
+        if (bin >= kDftBins) return 0.0f;
+        return atan2f(this->dftIm_[bin], this->dftRe_[bin]);
+    }
+
+    /** Комплексне значення біна (без нормування) */
+    SP_CONSTEXPR void getDftBin(uint8_t bin, float& re, float& im) const {
+        static_assert(kHasSlidingDft, "SignalFeatures::SlidingDft is disabled");
+        re = (bin < kDftBins) ? this->dftRe_[bin] : 0.0f;
+        im = (bin < kDftBins) ? this->dftIm_[bin] : 0.0f;
+    }
+
+    /** Вихід IIR-фільтра (останньої секції каскаду) */
+    SP_CONSTEXPR float getLowpass() const {
+        static_assert(kHasLowpass, "SignalFeatures::Lowpass is disabled");
+        return this->lowpassValue();
+    }
 
     // ========================================
     // ПОХІДНА ТА ІНТЕГРАТОР
     // ========================================
 
     /** Сира похідна dv/dt */
-    float getDerivative() const { return derivative_; }
+    SP_CONSTEXPR float getDerivative() const {
+        static_assert(kHasDerivative, "SignalFeatures::Derivative is disabled");
+        return this->derivValue();
+    }
 
     /** Згладжена похідна */
-    float getDerivativeFiltered() const { return derivativeFiltered_; }
+    SP_CONSTEXPR float getDerivativeFiltered() const {
+        static_assert(kHasDerivative, "SignalFeatures::Derivative is disabled");
+        return this->derivFilteredValue();
+    }
 
     /** Накопичений інтеграл */
-    float getIntegral() const { return integrator_; }
+    SP_CONSTEXPR float getIntegral() const {
+        static_assert(kHasIntegral, "SignalFeatures::Integral is disabled");
+        return this->integralValue();
+    }
 
     /** Скидання тільки інтегратора (без інших даних) */
-    void resetIntegral() {
-        integrator_ = 0.0f;
-        lastIntegrandValue_ = 0.0f;
+    SP_CONSTEXPR void resetIntegral() {
+        this->integralReset();
+    }
+
+    // ========================================
+    // МЕДІАНА ТА ПЕРЦЕНТИЛІ
+    // ========================================
+
+    /** Медіана вікна (для парного count - середнє двох центральних значень), O(1) */
+    SP_CONSTEXPR float getMedian() const {
+        static_assert(kHasMedian, "SignalFeatures::Median is disabled");
+        return (count_ > 0) ? this->quantile(0.5f, count_) : 0.0f;
+    }
+
+    /**
+     * Перцентиль вікна з лінійною інтерполяцією між сусідніми рангами, O(1)
+     * @param percent Перцентиль 0 - 100 (0 - min, 50 - медіана, 100 - max)
+     */
+    SP_CONSTEXPR float getPercentile(float percent) const {
+        static_assert(kHasMedian, "SignalFeatures::Median is disabled");
+        if (count_ == 0) return 0.0f;
+        percent = (percent < 0.0f) ? 0.0f : (percent > 100.0f) ? 100.0f : percent;
+        return this->quantile(percent * 0.01f, count_);
+    }
+
+    /** Медіана абсолютних відхилень від медіани (MAD), O(N/2) без сортування */
+    SP_CONSTEXPR float getMAD() const {
+        static_assert(kHasMedian, "SignalFeatures::Median is disabled");
+        return (count_ > 0) ? this->mad(getMedian(), count_) : 0.0f;
     }
 
     // ========================================
@@ -340,7 +3757,7 @@ public:
      * @param sigmaThreshold Поріг (за замовчуванням 3.0)
      * @return true якщо значення є викидом
      */
-    bool isOutlier(T value, float sigmaThreshold = 3.0f) const {
+    SP_CONSTEXPR bool isOutlier(T value, float sigmaThreshold = 3.0f) const {
         if (count_ < 2) return false;
         
         float mean = getMean();
@@ -354,60 +3771,384 @@ public:
         return deviation > sigmaThreshold * stdDev;
     }
 
+    /**
+     * Перевірка значення на викид за модифікованим z-score (Iglewicz, Hoaglin):
+     *   0.6745 * |value - median| / MAD > threshold
+     * Медіана і MAD не зсуваються самими викидами, тож поодинокі стрибки
+     * не маскують наступні (на відміну від isOutlier())
+     * @param value Значення для перевірки
+     * @param threshold Поріг (за замовчуванням 3.5)
+     * @return true якщо значення є викидом (false при MAD = 0)
+     */
+    SP_CONSTEXPR bool isOutlierMAD(T value, float threshold = 3.5f) const {
+        static_assert(kHasMedian, "SignalFeatures::Median is disabled");
+        if (count_ < 2) return false;
+
+        float median = getMedian();
+        float madValue = this->mad(median, count_);
+
+        if (madValue == 0.0f) return false;
+
+        float deviation = (float)value - median;
+        if (deviation < 0.0f) deviation = -deviation;
+
+        return 0.6745f * deviation > threshold * madValue;
+    }
+
     /**
      * Перевірка стабільності сигналу
      * @param maxStdDev Максимальне допустиме стандартне відхилення
      * @return true якщо сигнал стабільний
      */
-    bool isStable(float maxStdDev) const {
-        return (count_ >= N / 2) && (getStdDev() < maxStdDev);
+    SP_CONSTEXPR bool isStable(float maxStdDev) const {
+        return (count_ >= Ring::capacity() / 2) && (getStdDev() < maxStdDev);
     }
 
     /**
      * Перевірка чи буфер заповнений
      */
-    bool isFull() const {
-        return count_ == N;
+    SP_CONSTEXPR bool isFull() const {
+        return count_ == Ring::capacity();
     }
 
     /**
      * Перевірка чи буфер порожній
      */
-    bool isEmpty() const {
+    SP_CONSTEXPR bool isEmpty() const {
         return count_ == 0;
     }
 
+    // ========================================
+    // ТРИГЕРИ
+    // ========================================
+
+    /**
+     * Реєстрація порогового тригера: перевіряється всередині add()/addBlock(),
+     * callback викликається тільки при зміні стану (замість опитування в циклі)
+     * @param metric Величина (стадія має бути увімкнена)
+     * @param condition Above або Below
+     * @param threshold Поріг спрацювання (для StdDev - у одиницях сигналу)
+     * @param hysteresis Відступ від порогу для скидання (0 - без гістерезису).
+     *                   Для StdDev + Above рівень скидання обмежується знизу нулем і перевіряється
+     *                   включно: відступ >= threshold - скидання тільки при нульовому розкиді (сталий сигнал)
+     * @param holdSamples Скільки значень поспіль умова має виконуватися (0 або 1 - одразу).
+     *                    addBlock() перевіряє тригери один раз у кінці блоку і зараховує всі n значень
+     * @param callback Функція, що викликається при активації та скиданні
+     * @param context Довільний вказівник для callback-а
+     * @return Номер тригера (0 до kTriggerSlots - 1) або -1, якщо немає вільного слота,
+     *         callback порожній або стадія величини вимкнена
+     */
+    SP_CONSTEXPR int8_t addTrigger(SignalTrigger::Metric metric, SignalTrigger::Condition condition,
+                      float threshold, float hysteresis, uint16_t holdSamples,
+                      SignalTrigger::Callback callback, void* context = 0) {
+        static_assert(kHasTriggers, "SignalFeatures::Triggers is disabled");
+        bool available = (metric == SignalTrigger::Value)
+            || (metric == SignalTrigger::Mean && kHasMean)
+            || (metric == SignalTrigger::StdDev && kHasVariance)
+            || (metric == SignalTrigger::Ema && kHasEma)
+            || (metric == SignalTrigger::Lowpass && kHasLowpass)
+            || ((metric == SignalTrigger::Derivative || metric == SignalTrigger::DerivativeFiltered) && kHasDerivative);
+        if (callback == 0 || !available) return -1;
+
+        for (uint8_t id = 0; id < kTriggerSlots; id++) {
+            sp_detail::TriggerSlot& t = this->triggers_[id];
+            if (t.callback != 0) continue;
+
+            if (hysteresis < 0.0f) hysteresis = -hysteresis;
+            float off = (condition == SignalTrigger::Above) ? threshold - hysteresis : threshold + hysteresis;
+            if (metric == SignalTrigger::StdDev) {
+                // Дисперсія порівнюється з квадратом порогу
+                threshold = (threshold > 0.0f) ? threshold * threshold : 0.0f;
+                off = (off > 0.0f) ? off * off : 0.0f;
+            }
+            t.context = context;
+            t.onLevel = threshold;
+            t.offLevel = off;
+            t.run = 0;
+            t.hold = (holdSamples > 0) ? holdSamples : 1;
+            t.metric = (uint8_t)metric;
+            t.condition = (uint8_t)condition;
+            t.active = false;
+            t.callback = callback;
+            this->triggerCount_++;
+            return (int8_t)id;
+        }
+        return -1;
+    }
+
+    /** Видалення тригера (без виклику callback-а) */
+    SP_CONSTEXPR void removeTrigger(uint8_t id) {
+        static_assert(kHasTriggers, "SignalFeatures::Triggers is disabled");
+        if (id >= kTriggerSlots || this->triggers_[id].callback == 0) return;
+        this->triggers_[id].callback = 0;
+        this->triggerCount_--;
+    }
+
+    /** Поточний стан тригера */
+    SP_CONSTEXPR bool isTriggerActive(uint8_t id) const {
+        static_assert(kHasTriggers, "SignalFeatures::Triggers is disabled");
+        return id < kTriggerSlots && this->triggers_[id].callback != 0 && this->triggers_[id].active;
+    }
+
+    // ========================================
+    // СПЕКТР
+    // ========================================
+
+    /**
+     * Спектр вікна (тільки для N = 2^k): дійсне radix-2 FFT
+     * Буфер читається в логічному порядку (від найстарішого значення) прямо з кільця,
+     * з множенням на вікно та bit-reverse перестановкою за один прохід - без копії.
+     * Таблиці вікна та поворотних множників генеруються під час компіляції (flash, 8 * N байт).
+     * До заповнення буфера бракуючі значення на початку вікна - нулі.
+     * @tparam Window Вікно SpectrumWindow (за замовчуванням Hann)
+     * @param out Масив із N float: робочий буфер FFT і результат
+     * @param output Формат результату SpectrumOutput (Complex - N значень, інші - N/2 + 1)
+     * @param sampleRateHz Частота дискретизації (потрібна тільки для Psd)
+     */
+    template<int Window>
+    SP_CONSTEXPR void computeSpectrum(float* out, int output, float sampleRateHz = 1.0f) const {
+        static_assert(Ring::kFixed && Ring::kPow2 && kSpectrumSize >= 8, "computeSpectrum() needs power-of-two compile-time N >= 8");
+        const uint32_t M = kSpectrumSize / 2;
+        const float* w = sp_detail::WindowTable<kSpectrumSize, Window>::value;
+
+        const uint32_t pad = kSpectrumSize - count_;
+        const uint32_t start = (count_ == kSpectrumSize) ? index_ : 0;
+        uint32_t rev = 0;
+        for (uint32_t m = 0; m < M; m++) {
+            uint32_t i = 2 * m;
+            out[2 * rev] = (i < pad) ? 0.0f : w[i] * (float)buffer_[(start + i - pad) & (kSpectrumSize - 1)];
+            i++;
+            out[2 * rev + 1] = (i < pad) ? 0.0f : w[i] * (float)buffer_[(start + i - pad) & (kSpectrumSize - 1)];
+            // Наступний індекс у bit-reverse порядку
+            uint32_t bit = M >> 1;
+            while (rev & bit) { rev ^= bit; bit >>= 1; }
+            rev |= bit;
+        }
+
+        sp_detail::RealFft<kSpectrumSize>::run(out);
+        if (output == SpectrumOutput::Complex) return;
+
+        float sumW = 0.0f, sumW2 = 0.0f;
+        for (uint32_t i = 0; i < kSpectrumSize; i++) {
+            sumW += w[i];
+            sumW2 += w[i] * w[i];
+        }
+        // Magnitude: амплітуда синусоїди; Power: Парсеваль з поправкою на енергію вікна
+        float scale;
+        bool squared = (output != SpectrumOutput::Magnitude);
+        if (!squared) {
+            scale = 1.0f / sumW;
+        } else {
+            scale = 1.0f / ((float)kSpectrumSize * sumW2);
+            if (output == SpectrumOutput::Psd) scale *= (float)kSpectrumSize / sampleRateHz;
+        }
+
+        // Перетворення на місці: out[k] читає out[2k], out[2k + 1] (k <= 2k)
+        float nyquist = out[1];
+        for (uint32_t k = 0; k < M; k++) {
+            float re = out[2 * k];
+            float im = (k == 0) ? 0.0f : out[2 * k + 1];
+            float p = re * re + im * im;
+            float v = squared ? p * scale : sp_detail::mathSqrt(p) * scale;
+            out[k] = (k == 0) ? v : 2.0f * v;   // Однобічний спектр
+        }
+        float pn = nyquist * nyquist;
+        out[M] = squared ? pn * scale : sp_detail::mathSqrt(pn) * scale;
+    }
+
+    /** computeSpectrum() з вікном Hann */
+    SP_CONSTEXPR void computeSpectrum(float* out, int output = SpectrumOutput::Magnitude, float sampleRateHz = 1.0f) const {
+        computeSpectrum<SpectrumWindow::Hann>(out, output, sampleRateHz);
+    }
+
+    /** Частота біна k, Гц */
+    static SP_CONSTEXPR float getBinFrequency(uint32_t k, float sampleRateHz) {
+        static_assert(Ring::kFixed, "getBinFrequency() needs a compile-time window (SignalProcessor)");
+        return (float)k * sampleRateHz / (float)Ring::kCapacity;
+    }
+
+    /**
+     * Потужність у смузі частот [fLowHz, fHighHz] за результатом SpectrumOutput::Power
+     * (сума бінів; для всієї смуги 0..fs/2 - середній квадрат сигналу)
+     */
+    static SP_CONSTEXPR float getBandPower(const float* power, float fLowHz, float fHighHz, float sampleRateHz) {
+        float e = 0.0f;
+        for (uint32_t k = 0; k <= Ring::kCapacity / 2; k++) {
+            float f = getBinFrequency(k, sampleRateHz);
+            if (f >= fLowHz && f <= fHighHz) e += power[k];
+        }
+        return e;
+    }
+
     // ========================================
     // ДОСТУП ДО ДАНИХ
     // ========================================
 
     /**
      * Прямий доступ до циклічного буфера
-     * УВАГА: порядок елементів може бути не послідовний!
+     * УВАГА: порядок елементів може бути не послідовний! Для хронологічного порядку - getView()
      */
-    const T* getBuffer() const { 
+    SP_CONSTEXPR const T* getBuffer() const { 
         return buffer_; 
     }
 
+    /**
+     * Вміст буфера в хронологічному порядку: два суцільні сегменти без копіювання
+     * Дійсне до наступного add()/addBlock()/reset()
+     */
+    SP_CONSTEXPR RingView<T> getView() const {
+        RingView<T> v;
+        if (count_ == Ring::capacity()) {
+            v.first = buffer_ + index_;
+            v.firstSize = Ring::capacity() - index_;
+            v.second = buffer_;
+            v.secondSize = index_;
+        } else {
+            v.first = buffer_;
+            v.firstSize = count_;
+            v.second = buffer_;
+            v.secondSize = 0;
+        }
+        return v;
+    }
+
+    /**
+     * k-те значення з кінця без побудови представлення (0 - найновіше)
+     * @param k Від 0 до getCount() - 1
+     */
+    SP_CONSTEXPR T getLatest(SizeType k) const {
+        return buffer_[Ring::advance(index_, Ring::capacity() - 1 - k)];
+    }
+
     /**
      * Отримання буферу розміру
      */
-    uint16_t getBufferSize() const {
-        return N;
+    SP_CONSTEXPR SizeType getBufferSize() const {
+        return Ring::capacity();
+    }
+
+    /** Індекс буфера для наступного запису (для ExternalBuffer - очікувана позиція DMA) */
+    SP_CONSTEXPR SizeType getWriteIndex() const {
+        return index_;
     }
 
     /**
      * Отримання останнього доданого значення
      */
-    T getLastValue() const {
-        return lastValue_;
+    SP_CONSTEXPR T getLastValue() const {
+        static_assert(kHasDerivative, "SignalFeatures::Derivative is disabled");
+        return this->lastValue_;
     }
 
     /**
      * Отримання останньої часової мітки
      */
-    uint32_t getLastTime() const {
-        return lastTimeMs_;
+    SP_CONSTEXPR uint32_t getLastTime() const {
+        static_assert(kHasDerivative || kHasIntegral, "SignalFeatures::Derivative/Integral are disabled");
+        return this->lastTime_;
+    }
+
+    // ========================================
+    // ІНСТРУМЕНТАЦІЯ
+    // ========================================
+
+    /**
+     * Clock-функція для вимірювання тактів add()/addBlock()
+     * @param clock Лічильник, що зростає (наприклад, читання DWT->CYCCNT); 0 - не вимірювати
+     *
+     *   static uint32_t cycles() { return DWT->CYCCNT; }
+     *   sensor.setInstrumentationClock(cycles);
+     */
+    void setInstrumentationClock(SignalCounters::Clock clock) {
+        static_assert(kInstrumented, "SignalFeatures::Instrumentation is disabled");
+        this->clock_ = clock;
+    }
+
+    /**
+     * Знімок лічильників гарячого шляху
+     */
+    SignalCounters getCounters() const {
+        static_assert(kInstrumented, "SignalFeatures::Instrumentation is disabled");
+        return this->counters_;
+    }
+
+    /**
+     * Скидання лічильників (reset() їх не скидає)
+     */
+    void resetCounters() {
+        static_assert(kInstrumented, "SignalFeatures::Instrumentation is disabled");
+        this->counters_.reset();
+    }
+};
+
+/**
+ * @brief Універсальний процесор сигналів для embedded систем
+ * 
+ * Призначення:
+ *  - Обробка сигналів сенсорів (акселерометр, гіроскоп, температура, тощо)
+ *  - Моніторинг аналогових сигналів (напруга, струм, потужність)
+ *  - Обробка даних з АЦП
+ *  - Контроль якості сигналів
+ *  - Real-time фільтрація та аналіз
+ * 
+ * Можливості:
+ *  - Базова статистика: Mean, Min, Max, StdDev, Variance, Range
+ *  - Фільтри: EMA, SMA, IIR (каскад біквадів, Баттерворт ФНЧ/ФВЧ/смуговий)
+ *  - Похідна (raw і згладжена)
+ *  - Інтегратор (трапецоїдальний метод)
+ *  - Виявлення викидів (outlier detection)
+ *  - Контроль стабільності сигналу
+ * 
+ * Шаблонні параметри:
+ *   T — тип даних (float, double, int16_t, int32_t, uint16_t)
+ *   N — розмір циклічного буфера (від 2). Для N = 2^k індекс переходить через кінець маскою
+ *   Features — набір стадій SignalFeatures (за замовчуванням SignalFeatures::Default - усі)
+ *   Accumulator — акумулятор сум: FloatAccumulator (типовий), KahanAccumulator,
+ *                 DoubleAccumulator, ExactAccumulator (int64, тільки цілі T)
+ * 
+ * Використання пам'яті: N * sizeof(T) + ~100 байт з усіма стадіями (вимкнені стадії - 0 байт)
+ *                       +2*N*sizeof(SizeType) з SignalFeatures::MinMaxWedge
+ *                       +N*sizeof(T) з SignalFeatures::Median
+ * 
+ * @author Korzhak
+ * @version 1.0
+ * @date 2025
+ */
+template<typename T, uint32_t N, uint32_t Features = SignalFeatures::Default,
+         template<typename> class Accumulator = FloatAccumulator>
+class SignalProcessor
+    : public SignalProcessorCore<T, sp_detail::Ring<N>, Features, Accumulator>
+{
+    static_assert(N >= 2, "Buffer size must be at least 2");
+    static_assert(N <= 0x80000000u, "Buffer size must not exceed 2^31");
+
+    typedef SignalProcessorCore<T, sp_detail::Ring<N>, Features, Accumulator> Core;
+
+public:
+    /**
+     * Конструктор з типовими параметрами фільтрів
+     */
+    SP_CONSTEXPR SignalProcessor() {
+        static_assert(!Core::kExternalBuffer, "SignalFeatures::ExternalBuffer requires SignalProcessor(T* storage)");
+    }
+
+    /**
+     * Конструктор над буфером користувача (SignalFeatures::ExternalBuffer)
+     * @param storage N значень: кільце DMA АЦП, область DTCM/CCM тощо. Вміст не
+     *                ініціалізується - вікно порожнє до add()/addBlock()/commitSamples()
+     */
+    explicit SP_CONSTEXPR SignalProcessor(T* storage)
+        : Core(storage)
+    {
+        static_assert(Core::kExternalBuffer, "SignalProcessor(T* storage) requires SignalFeatures::ExternalBuffer");
+    }
+
+    /**
+     * Оператор += для зручного додавання
+     */
+    SP_CONSTEXPR SignalProcessor& operator+=(T value) {
+        this->add(value);
+        return *this;
     }
 };
 
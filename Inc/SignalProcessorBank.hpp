@@ -0,0 +1,412 @@
+#ifndef SIGNAL_PROCESSOR_BANK_HPP_
+#define SIGNAL_PROCESSOR_BANK_HPP_
+
+#include "SignalProcessor.hpp"
+
+namespace sp_detail {
+
+/**
+ * Каскад біквадів для всіх каналів банку: спільні коефіцієнти, стан DF2T у SoA
+ * Секції - зовнішній цикл, канали - внутрішній (незалежні лінії, векторизується)
+ */
+template<uint8_t Sections, uint16_t Channels>
+struct BankLowpassStage {
+    BiquadCoeffs lpCoeffs_[Sections];
+    float lpZ1_[Sections][Channels];
+    float lpZ2_[Sections][Channels];
+    float lowpass_[Channels];
+
+    BankLowpassStage() {
+        lpCoeffs_[0] = BiquadCoeffs::firstOrderLowpass(0.1f);
+        for (uint8_t k = 1; k < Sections; k++) lpCoeffs_[k] = BiquadCoeffs::identity();
+        lowpassReset();
+    }
+
+    void lowpassReset() {
+        for (uint8_t k = 0; k < Sections; k++) {
+            for (uint16_t c = 0; c < Channels; c++) lpZ1_[k][c] = lpZ2_[k][c] = 0.0f;
+        }
+        for (uint16_t c = 0; c < Channels; c++) lowpass_[c] = 0.0f;
+    }
+
+    template<typename T>
+    void lowpassUpdate(const T* frame, bool first) {
+        float* y = lowpass_;
+        for (uint16_t c = 0; c < Channels; c++) y[c] = (float)frame[c];
+
+        for (uint8_t k = 0; k < Sections; k++) {
+            const BiquadCoeffs q = lpCoeffs_[k];
+            float* z1 = lpZ1_[k];
+            float* z2 = lpZ2_[k];
+            if (first) {
+                const float g = q.dcGain();
+                for (uint16_t c = 0; c < Channels; c++) {
+                    float x = y[c];
+                    y[c] = g * x;
+                    z1[c] = y[c] - q.b0 * x;
+                    z2[c] = q.b2 * x - q.a2 * y[c];
+                }
+            } else {
+                for (uint16_t c = 0; c < Channels; c++) {
+                    float x = y[c];
+                    float out = q.b0 * x + z1[c];
+                    z1[c] = q.b1 * x - q.a1 * out + z2[c];
+                    z2[c] = q.b2 * x - q.a2 * out;
+                    y[c] = out;
+                }
+            }
+        }
+    }
+};
+
+template<uint16_t Channels>
+struct BankLowpassStage<0, Channels> {
+    void lowpassReset() {}
+    template<typename T>
+    void lowpassUpdate(const T*, bool) {}
+};
+
+} // namespace sp_detail
+
+/**
+ * @brief Банк процесорів сигналів для багатоканальних даних (structure-of-arrays)
+ *
+ * Призначення:
+ *  - Багатоканальні АЦП у режимі сканування (DMA пише кадр з усіх каналів)
+ *  - IMU (3 осі акселерометра + 3 осі гіроскопа), групи струмових каналів
+ *
+ * Замість окремого SignalProcessor на кожен канал банк тримає буфери та
+ * акумулятори всіх каналів у SoA-розкладці зі спільним індексом запису.
+ * addFrame() оновлює sum/sumSq/EMA/min/max і IIR-фільтр усіх каналів одним проходом
+ * по незалежних лініях - цикл по каналах векторизується компілятором.
+ *
+ * Розкладка буфера: buffer_[кадр][канал] - кадр записується суцільно (memcpy).
+ *
+ * Getter-и мають ту саму семантику, що й у SignalProcessor
+ * (min/max - лінивий перерахунок після видалення екстремуму).
+ *
+ * Шаблонні параметри:
+ *   T — тип даних (float, int16_t, uint16_t, ...)
+ *   N — розмір вікна в кадрах (від 2)
+ *   Channels — кількість каналів (від 1)
+ *   Accumulator — акумулятор сум (як у SignalProcessor)
+ *   LowpassSections — кількість біквад-секцій IIR-фільтра (0 - без фільтра)
+ *
+ * Використання пам'яті: N * Channels * sizeof(T) + Channels * (2 * sizeof(Acc) + 4 + 2 * sizeof(T) + 1)
+ *                       + LowpassSections * (20 + 8 * Channels) + 4 * Channels з фільтром
+ */
+template<typename T, uint32_t N, uint16_t Channels,
+         template<typename> class Accumulator = FloatAccumulator,
+         uint8_t LowpassSections = 1>
+class SignalProcessorBank
+    : private sp_detail::BankLowpassStage<LowpassSections, Channels>
+{
+    static_assert(N >= 2, "Buffer size must be at least 2");
+    static_assert(N <= 0x80000000u, "Buffer size must not exceed 2^31");
+    static_assert(Channels >= 1, "Bank must have at least one channel");
+
+public:
+    /** Тип лічильника та індексу: uint16_t для N <= 65535, інакше uint32_t */
+    typedef typename sp_detail::Ring<N>::Index SizeType;
+
+    static const bool kHasLowpass = LowpassSections > 0;
+    static const uint8_t kLowpassSections = LowpassSections;
+
+private:
+    typedef sp_detail::Ring<N> Ring;
+    typedef Accumulator<T> Acc;
+    typedef typename Acc::Term AccTerm;
+    typedef typename Acc::Value AccValue;
+
+    // Циклічний буфер кадрів
+    T buffer_[N][Channels];
+    SizeType count_;        // Поточна кількість кадрів (0 до N)
+    SizeType index_;        // Індекс для наступного запису (0 до N-1)
+
+    // Статистика по каналах (SoA)
+    Acc sum_[Channels];     // Суми значень
+    Acc sumSq_[Channels];   // Суми квадратів
+    float ema_[Channels];   // Exponential Moving Average
+    mutable T minVal_[Channels];
+    mutable T maxVal_[Channels];
+    mutable uint8_t needRecalcMinMax_[Channels];   // Прапорці лінивого перерахунку (uint8_t - для векторизації)
+
+    float alphaEma_;        // Коефіцієнт EMA (спільний для всіх каналів)
+
+    /** Перерахунок min/max одного каналу по стовпцю буфера */
+    void recalculateMinMax(uint16_t channel) const {
+        T lo = buffer_[0][channel];
+        T hi = lo;
+        for (SizeType i = 1; i < count_; i++) {
+            T v = buffer_[i][channel];
+            lo = (v < lo) ? v : lo;
+            hi = (v > hi) ? v : hi;
+        }
+        minVal_[channel] = lo;
+        maxVal_[channel] = hi;
+        needRecalcMinMax_[channel] = 0;
+    }
+
+public:
+    /**
+     * Конструктор з типовими параметрами фільтрів
+     */
+    SignalProcessorBank() : alphaEma_(0.1f) {
+        reset();
+    }
+
+    // ========================================
+    // НАЛАШТУВАННЯ ПАРАМЕТРІВ
+    // ========================================
+
+    /**
+     * Встановлення коефіцієнта EMA для всіх каналів
+     * @param alpha Коефіцієнт (0.0 - 1.0). Більше значення = швидша реакція
+     */
+    void setEmaAlpha(float alpha) {
+        alphaEma_ = (alpha < 0.0f) ? 0.0f : (alpha > 1.0f) ? 1.0f : alpha;
+    }
+
+    /**
+     * Low-pass першого порядку для всіх каналів (як SignalProcessor::setLowpassAlpha)
+     * @param alpha Коефіцієнт (0.0 - 1.0). Менше значення = сильніше згладжування
+     */
+    void setLowpassAlpha(float alpha) {
+        static_assert(kHasLowpass, "Bank has no lowpass sections");
+        alpha = (alpha < 0.0f) ? 0.0f : (alpha > 1.0f) ? 1.0f : alpha;
+        this->lpCoeffs_[0] = BiquadCoeffs::firstOrderLowpass(alpha);
+        for (uint8_t k = 1; k < LowpassSections; k++) this->lpCoeffs_[k] = BiquadCoeffs::identity();
+    }
+
+    /**
+     * Коефіцієнти всіх секцій IIR-фільтра, спільні для всіх каналів
+     * @param coeffs Масив із LowpassSections секцій (наприклад, з Butterworth::lowpass())
+     */
+    void setLowpass(const BiquadCoeffs* coeffs) {
+        static_assert(kHasLowpass, "Bank has no lowpass sections");
+        for (uint8_t k = 0; k < LowpassSections; k++) this->lpCoeffs_[k] = coeffs[k];
+    }
+
+    // ========================================
+    // ДОДАВАННЯ ДАНИХ
+    // ========================================
+
+    /**
+     * Додавання кадру - по одному значенню для кожного каналу
+     * @param frame Масив із Channels значень
+     */
+    void addFrame(const T* frame) {
+        T* row = buffer_[index_];
+
+        if (count_ == 0) {
+            for (uint16_t c = 0; c < Channels; c++) {
+                AccTerm term = (AccTerm)frame[c];
+                sum_[c].add(term);
+                sumSq_[c].add(term * term);
+                ema_[c] = (float)frame[c];
+                minVal_[c] = maxVal_[c] = frame[c];
+                needRecalcMinMax_[c] = 0;
+            }
+            memcpy(row, frame, sizeof(T) * Channels);
+            this->lowpassUpdate(frame, true);
+            count_ = 1;
+            index_ = Ring::next(index_);
+            return;
+        }
+
+        const float a = alphaEma_;
+        const float b = 1.0f - alphaEma_;
+
+        if (count_ == N) {
+            // Буфер повний - найстаріший кадр видаляється зі статистики в тому ж проході
+            for (uint16_t c = 0; c < Channels; c++) {
+                T v = frame[c];
+                T old = row[c];
+                AccTerm term = (AccTerm)v;
+                AccTerm oldTerm = (AccTerm)old;
+                sum_[c].sub(oldTerm);
+                sumSq_[c].sub(oldTerm * oldTerm);
+                sum_[c].add(term);
+                sumSq_[c].add(term * term);
+                ema_[c] = a * (float)v + b * ema_[c];
+                // Якщо видаляємо min або max - позначаємо, що потрібен перерахунок
+                needRecalcMinMax_[c] |= (uint8_t)((old == minVal_[c]) | (old == maxVal_[c]));
+                // Поки прапорець перерахунку стоїть, значення min/max не використовуються
+                minVal_[c] = (v < minVal_[c]) ? v : minVal_[c];
+                maxVal_[c] = (v > maxVal_[c]) ? v : maxVal_[c];
+                row[c] = v;
+            }
+        } else {
+            for (uint16_t c = 0; c < Channels; c++) {
+                T v = frame[c];
+                AccTerm term = (AccTerm)v;
+                sum_[c].add(term);
+                sumSq_[c].add(term * term);
+                ema_[c] = a * (float)v + b * ema_[c];
+                minVal_[c] = (v < minVal_[c]) ? v : minVal_[c];
+                maxVal_[c] = (v > maxVal_[c]) ? v : maxVal_[c];
+                row[c] = v;
+            }
+            count_++;
+        }
+
+        this->lowpassUpdate(frame, false);
+        index_ = Ring::next(index_);
+    }
+
+    /**
+     * Пакетне додавання кадрів (чергування каналів: f0c0, f0c1, ..., f1c0, ...)
+     * @param frames Масив із nFrames * Channels значень
+     * @param nFrames Кількість кадрів
+     */
+    void addFrames(const T* frames, size_t nFrames) {
+        for (size_t i = 0; i < nFrames; i++) {
+            addFrame(frames + i * Channels);
+        }
+    }
+
+    /**
+     * Повне скидання всіх даних та статистики
+     */
+    void reset() {
+        count_ = 0;
+        index_ = 0;
+        for (uint16_t c = 0; c < Channels; c++) {
+            sum_[c].reset();
+            sumSq_[c].reset();
+            ema_[c] = 0.0f;
+            minVal_[c] = maxVal_[c] = 0;
+            needRecalcMinMax_[c] = 0;
+        }
+        this->lowpassReset();
+    }
+
+    // ========================================
+    // СТАТИСТИКА КАНАЛУ
+    // ========================================
+
+    /** Кількість каналів */
+    uint16_t getChannelCount() const { return Channels; }
+
+    /** Кількість кадрів у буфері (0 до N) */
+    SizeType getCount() const { return count_; }
+
+    /** Сума всіх значень каналу */
+    float getSum(uint16_t channel) const { return (float)sum_[channel].value(); }
+
+    /** Середнє арифметичне каналу */
+    float getMean(uint16_t channel) const {
+        return (count_ > 0) ? (float)(sum_[channel].value() / (AccValue)count_) : 0.0f;
+    }
+
+    /** Sample variance каналу (незміщена оцінка дисперсії) */
+    float getVariance(uint16_t channel) const {
+        if (count_ <= 1) return 0.0f;
+        AccValue mean = sum_[channel].value() / (AccValue)count_;
+        AccValue var = (sumSq_[channel].value() - (AccValue)count_ * mean * mean) / (AccValue)(count_ - 1);
+        return (var > 0) ? (float)var : 0.0f;
+    }
+
+    /** Стандартне відхилення каналу */
+    float getStdDev(uint16_t channel) const {
+        return sqrtf(getVariance(channel));
+    }
+
+    /** Коефіцієнт варіації каналу (CV) у відсотках */
+    float getCoefficientOfVariation(uint16_t channel) const {
+        float mean = getMean(channel);
+        if (mean == 0.0f) return 0.0f;
+        return (getStdDev(channel) / mean) * 100.0f;
+    }
+
+    /** Мінімальне значення каналу */
+    T getMin(uint16_t channel) const {
+        if (count_ == 0) return 0;
+        if (needRecalcMinMax_[channel]) recalculateMinMax(channel);
+        return minVal_[channel];
+    }
+
+    /** Максимальне значення каналу */
+    T getMax(uint16_t channel) const {
+        if (count_ == 0) return 0;
+        if (needRecalcMinMax_[channel]) recalculateMinMax(channel);
+        return maxVal_[channel];
+    }
+
+    /** Розмах каналу (різниця між max і min) */
+    float getRange(uint16_t channel) const {
+        return (float)(getMax(channel) - getMin(channel));
+    }
+
+    /** Зведення каналу для агрегації (SignalSummary::combine()), як SignalProcessor::summary() */
+    SignalSummary<T> summary(uint16_t channel) const {
+        if (count_ == 0) return SignalSummary<T>();
+        return SignalSummary<T>::fromSums(count_, (double)sum_[channel].value(),
+                                          (double)sumSq_[channel].value(), getMin(channel), getMax(channel));
+    }
+
+    /** Exponential Moving Average каналу */
+    float getEma(uint16_t channel) const { return ema_[channel]; }
+
+    /** Simple Moving Average каналу (те саме що getMean) */
+    float getSma(uint16_t channel) const { return getMean(channel); }
+
+    /** Вихід IIR-фільтра каналу */
+    float getLowpass(uint16_t channel) const {
+        static_assert(kHasLowpass, "Bank has no lowpass sections");
+        return this->lowpass_[channel];
+    }
+
+    // ========================================
+    // АНАЛІЗ СИГНАЛУ
+    // ========================================
+
+    /**
+     * Перевірка значення на викид (outlier) за 3-sigma правилом
+     * @param channel Канал
+     * @param value Значення для перевірки
+     * @param sigmaThreshold Поріг (за замовчуванням 3.0)
+     */
+    bool isOutlier(uint16_t channel, T value, float sigmaThreshold = 3.0f) const {
+        if (count_ < 2) return false;
+
+        float mean = getMean(channel);
+        float stdDev = getStdDev(channel);
+
+        if (stdDev == 0.0f) return false;
+
+        float deviation = (float)value - mean;
+        if (deviation < 0.0f) deviation = -deviation;
+
+        return deviation > sigmaThreshold * stdDev;
+    }
+
+    /**
+     * Перевірка стабільності каналу
+     * @param maxStdDev Максимальне допустиме стандартне відхилення
+     */
+    bool isStable(uint16_t channel, float maxStdDev) const {
+        return (count_ >= N / 2) && (getStdDev(channel) < maxStdDev);
+    }
+
+    /** Перевірка чи буфер заповнений */
+    bool isFull() const { return count_ == N; }
+
+    /** Перевірка чи буфер порожній */
+    bool isEmpty() const { return count_ == 0; }
+
+    // ========================================
+    // ДОСТУП ДО ДАНИХ
+    // ========================================
+
+    /**
+     * Прямий доступ до буфера кадрів: buffer[кадр * Channels + канал]
+     * УВАГА: порядок кадрів може бути не послідовний!
+     */
+    const T* getBuffer() const { return &buffer_[0][0]; }
+
+    /** Розмір вікна в кадрах */
+    SizeType getBufferSize() const { return N; }
+};
+
+#endif
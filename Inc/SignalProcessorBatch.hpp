@@ -0,0 +1,193 @@
+#ifndef SIGNAL_PROCESSOR_BATCH_HPP_
+#define SIGNAL_PROCESSOR_BATCH_HPP_
+
+#include "SignalProcessor.hpp"
+#include "SignalProcessorBank.hpp"
+
+#include <atomic>
+#include <thread>
+
+/**
+ * @brief Паралельна пакетна обробка багатьох процесорів (host / Linux-шлюз)
+ *
+ * Призначення:
+ *  - Офлайн-прогін записаних захоплень через десятки тисяч процесорів (по одному на давач)
+ *  - Матриця семплів у чергуванні: samples[кадр * stride + канал]
+ *
+ * Канали діляться на порції (chunkChannels), які потоки пулу забирають атомарним
+ * лічильником: потік, що звільнився, бере наступну порцію (динамічний розподіл без
+ * черг і блокувань). Канали незалежні, тому кожна порція обробляє весь часовий
+ * діапазон без синхронізації. Значення каналу збираються з матриці блоками по
+ * kGatherBlock кадрів у локальний буфер і йдуть в addBlock() (суцільні сегменти,
+ * векторні ядра); сусідні канали порції читають ті самі рядки кешу матриці.
+ *
+ * Стан каналів - у SignalChannel<P>, вирівняному на рядок кешу: сусідні процесори,
+ * які оновлюють різні потоки, ніколи не ділять рядок (без false sharing).
+ *
+ * Лише для host: потрібні <thread> і <atomic> (збирати з -pthread). Для МК -
+ * SignalProcessorBank або SignalProcessorSpsc.
+ *
+ *   static SignalChannel<SignalProcessor<int16_t, 1000> > sensors[20000];
+ *   SignalProcessorBatch batch;                        // Потоків - за кількістю ядер
+ *   batch.process(sensors, 20000, capture, frames);    // capture[frame * 20000 + sensor]
+ */
+
+#ifndef SIGNAL_PROCESSOR_CACHE_LINE
+#define SIGNAL_PROCESSOR_CACHE_LINE 64
+#endif
+
+/** Процесор каналу, вирівняний на рядок кешу */
+template<typename P>
+struct alignas(SIGNAL_PROCESSOR_CACHE_LINE) SignalChannel {
+    P processor;
+};
+
+class SignalProcessorBatch {
+public:
+    /** Кадрів в одному зборі значень каналу (локальний буфер на стеку потоку) */
+    static const size_t kGatherBlock = 256;
+
+    /** Найбільша кількість потоків пулу */
+    static const unsigned kMaxThreads = 256;
+
+    /**
+     * @param threads Кількість потоків, разом з потоком виклику (0 - std::thread::hardware_concurrency())
+     * @param chunkChannels Каналів в одній порції роботи (0 - 64)
+     */
+    explicit SignalProcessorBatch(unsigned threads = 0, size_t chunkChannels = 0)
+        : threads_(threads), chunk_(chunkChannels)
+    {
+        if (threads_ == 0) threads_ = std::thread::hardware_concurrency();
+        if (threads_ == 0) threads_ = 1;
+        if (threads_ > kMaxThreads) threads_ = kMaxThreads;
+        if (chunk_ == 0) chunk_ = 64;
+    }
+
+    unsigned getThreadCount() const { return threads_; }
+
+    /**
+     * Обробка матриці через процесори каналів
+     * @param channels Процесори: channels[c] отримує samples[f * stride + c]
+     * @param channelCount Кількість каналів
+     * @param samples Матриця у чергуванні
+     * @param frames Кількість кадрів (рядків матриці)
+     * @param stride Відстань між кадрами в елементах (0 - channelCount)
+     */
+    template<typename P, typename T>
+    void process(SignalChannel<P>* channels, size_t channelCount,
+                 const T* samples, size_t frames, size_t stride = 0) {
+        ChannelJob<P, T> job = { channels, samples, frames, stride ? stride : channelCount, false, 0, 0 };
+        run(job, channelCount, chunk_);
+    }
+
+    /**
+     * Обробка матриці з рівномірними часовими мітками (для похідної/інтегралу)
+     * Мітка кадру f = startTime + f * period
+     */
+    template<typename P, typename T>
+    void process(SignalChannel<P>* channels, size_t channelCount,
+                 const T* samples, size_t frames, size_t stride,
+                 uint32_t startTime, uint32_t period) {
+        ChannelJob<P, T> job = { channels, samples, frames, stride ? stride : channelCount, true, startTime, period };
+        run(job, channelCount, chunk_);
+    }
+
+    /**
+     * Обробка матриці банками: банк b отримує канали [b * Channels, (b + 1) * Channels) кожного кадру
+     * @param banks Банки (кожен варто обгорнути в SignalChannel або вирівняти окремо)
+     * @param bankCount Кількість банків
+     * @param samples Матриця у чергуванні
+     * @param frames Кількість кадрів
+     * @param stride Відстань між кадрами в елементах (0 - bankCount * Channels)
+     */
+    template<typename T, uint32_t N, uint16_t Channels, template<typename> class Acc, uint8_t Sections>
+    void process(SignalChannel<SignalProcessorBank<T, N, Channels, Acc, Sections> >* banks, size_t bankCount,
+                 const T* samples, size_t frames, size_t stride = 0) {
+        BankJob<SignalProcessorBank<T, N, Channels, Acc, Sections>, T, Channels> job =
+            { banks, samples, frames, stride ? stride : bankCount * Channels };
+        run(job, bankCount, 1);
+    }
+
+private:
+    unsigned threads_;
+    size_t chunk_;
+
+    template<typename P, typename T>
+    struct ChannelJob {
+        SignalChannel<P>* channels;
+        const T* samples;
+        size_t frames;
+        size_t stride;
+        bool timed;
+        uint32_t startTime;
+        uint32_t period;
+
+        /** Порція каналів [first, last) через весь часовий діапазон */
+        void operator()(size_t first, size_t last) const {
+            T block[kGatherBlock];
+            for (size_t f0 = 0; f0 < frames; f0 += kGatherBlock) {
+                size_t n = (frames - f0 < kGatherBlock) ? frames - f0 : kGatherBlock;
+                const T* rows = samples + f0 * stride;
+                for (size_t c = first; c < last; c++) {
+                    const T* src = rows + c;
+                    for (size_t i = 0; i < n; i++) block[i] = src[i * stride];
+                    if (timed) {
+                        channels[c].processor.addBlock(block, n, startTime + (uint32_t)f0 * period, period);
+                    } else {
+                        channels[c].processor.addBlock(block, n);
+                    }
+                }
+            }
+        }
+    };
+
+    template<typename B, typename T, uint16_t Channels>
+    struct BankJob {
+        SignalChannel<B>* banks;
+        const T* samples;
+        size_t frames;
+        size_t stride;
+
+        void operator()(size_t first, size_t last) const {
+            for (size_t b = first; b < last; b++) {
+                const T* src = samples + b * Channels;
+                if (stride == Channels) {
+                    banks[b].processor.addFrames(src, frames);     // Кадри суцільні - блочний шлях
+                } else {
+                    for (size_t f = 0; f < frames; f++) banks[b].processor.addFrame(src + f * stride);
+                }
+            }
+        }
+    };
+
+    /** Пул: потоки забирають порції [k * chunk, (k + 1) * chunk) атомарним лічильником */
+    template<typename Job>
+    void run(const Job& job, size_t count, size_t chunk) {
+        if (count == 0) return;
+        size_t chunks = (count + chunk - 1) / chunk;
+        unsigned workers = (threads_ < chunks) ? threads_ : (unsigned)chunks;
+        std::atomic<size_t> next(0);
+
+        struct Worker {
+            static void loop(const Job* job, std::atomic<size_t>* next, size_t count, size_t chunk) {
+                for (;;) {
+                    size_t k = next->fetch_add(1, std::memory_order_relaxed);
+                    size_t first = k * chunk;
+                    if (first >= count) return;
+                    size_t last = (count - first < chunk) ? count : first + chunk;
+                    (*job)(first, last);
+                }
+            }
+        };
+
+        std::thread pool[kMaxThreads];
+        unsigned spawned = 0;
+        for (unsigned t = 1; t < workers; t++) {
+            pool[spawned++] = std::thread(&Worker::loop, &job, &next, count, chunk);
+        }
+        Worker::loop(&job, &next, count, chunk);    // Потік виклику - теж робітник
+        for (unsigned t = 0; t < spawned; t++) pool[t].join();
+    }
+};
+
+#endif
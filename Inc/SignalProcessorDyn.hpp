@@ -0,0 +1,178 @@
+#ifndef SIGNAL_PROCESSOR_DYN_HPP_
+#define SIGNAL_PROCESSOR_DYN_HPP_
+
+#include "SignalProcessor.hpp"
+
+/**
+ * @brief SignalProcessor з розміром вікна, заданим під час виконання
+ *
+ * Для прошивок, де розміри вікон приходять з конфігурації розгортання: замість
+ * набору інстанціювань з фіксованими N (і RAM, округленої вгору до найближчого)
+ * буфер кожного процесора береться з арени або пулу рівно потрібного розміру.
+ *
+ *   static uint8_t memory[32 * 1024];
+ *   SignalArena arena(memory, sizeof(memory));      // Один раз при старті
+ *
+ *   static SignalProcessorDyn<int16_t> channel[64];
+ *   for (k = 0; k < config.channels; k++) {
+ *       if (!channel[k].init(arena, config.window[k])) fault();
+ *   }
+ *   ...
+ *   channel[k].add(adcValue, HAL_GetTick());        // Далі - без жодної алокації
+ *
+ * Той самий код, що й SignalProcessor (SignalProcessorCore), з політикою кільця
+ * sp_detail::DynRing замість Ring<N>: add()/addBlock(), getter-и, тригери, кеш
+ * статистики, лічильники і збереження стану - спільні. Не підтримуються стадії,
+ * пам'ять яких залежить від N (MinMaxWedge, Median, SlidingDft), ExternalBuffer
+ * (буфер і так зовнішній), а також getFir() і computeSpectrum() - static_assert.
+ *
+ * Гаряче і холодне розділені: в об'єкті - лише керування кільцем, суми, min/max
+ * і стан фільтрів (усе, що читає add() і getter-и), буфер вікна - окремо в арені.
+ * Масив процесорів лежить щільно (sizeof(SignalProcessorDyn<int16_t>) = 144 байти з
+ * типовими стадіями, незалежно від ємності), тому обхід getter-ів по всіх каналах
+ * не тягне в кеш рядки буферів.
+ */
+
+#ifndef SIGNAL_PROCESSOR_DYN_ALIGN
+#define SIGNAL_PROCESSOR_DYN_ALIGN 32       // Вирівнювання буферів в арені (степінь двійки)
+#endif
+
+/**
+ * Арена над пам'яттю користувача: послідовне виділення без звільнення
+ * Будь-який інший пул з методом void* allocate(size_t bytes, size_t align) теж підходить для init()
+ */
+class SignalArena {
+public:
+    SignalArena(void* memory, size_t size)
+        : base_((uint8_t*)memory), size_(size), used_(0)
+    {}
+
+    /**
+     * Блок bytes байт, вирівняний на align (степінь двійки)
+     * @return 0, якщо арена вичерпана
+     */
+    void* allocate(size_t bytes, size_t align) {
+        size_t pad = (size_t)(0 - (uintptr_t)(base_ + used_)) & (align - 1);
+        if (pad > size_ - used_ || bytes > size_ - used_ - pad) return 0;
+        used_ += pad;
+        void* p = base_ + used_;
+        used_ += bytes;
+        return p;
+    }
+
+    size_t getCapacity() const { return size_; }
+    size_t getUsed() const { return used_; }
+    size_t getFree() const { return size_ - used_; }
+
+    /** Звільнення всієї арени: процесори, що з неї ініціалізовані, стають недійсними */
+    void reset() { used_ = 0; }
+
+private:
+    uint8_t* base_;
+    size_t size_;
+    size_t used_;
+};
+
+namespace sp_detail {
+
+/**
+ * Політика кільця ємності часу виконання для SignalProcessorCore
+ * Інтерфейс - як у Ring<N>; kCapacity - найбільша ємність, стадії з пам'яттю N вимкнені
+ */
+struct DynRing {
+    typedef uint32_t Index;
+    static const bool kPow2 = false;
+    static const bool kFixed = false;
+    static const uint32_t kCapacity = 0x80000000u;
+
+    uint32_t capacity_;     // Розмір вікна (0 - не ініціалізовано)
+
+    SP_CONSTEXPR DynRing() : capacity_(0) {}
+
+    SP_CONSTEXPR uint32_t capacity() const { return capacity_; }
+
+    /** (i + k) mod capacity_ для i < capacity_, k <= capacity_ */
+    SP_CONSTEXPR Index advance(Index i, uint32_t k) const {
+        uint32_t j = i + k;
+        return (j >= capacity_) ? j - capacity_ : j;
+    }
+
+    SP_CONSTEXPR Index next(Index i) const { return advance(i, 1); }
+
+    void resize(uint32_t capacity) { capacity_ = capacity; }
+};
+
+} // namespace sp_detail
+
+/**
+ * @tparam T Тип даних
+ * @tparam Features Набір стадій SignalFeatures (без MinMaxWedge, Median, SlidingDft, ExternalBuffer)
+ * @tparam Accumulator Акумулятор суми та суми квадратів, як у SignalProcessor
+ */
+template<typename T, uint32_t Features = SignalFeatures::Default,
+         template<typename> class Accumulator = FloatAccumulator>
+class SignalProcessorDyn
+    : public SignalProcessorCore<T, sp_detail::DynRing, Features, Accumulator>
+{
+    typedef SignalProcessorCore<T, sp_detail::DynRing, Features, Accumulator> Core;
+
+    static const uint32_t kNeedsFixedN = SignalFeatures::MinMaxWedge | SignalFeatures::Median |
+        SignalFeatures::SlidingDft | SignalFeatures::ExternalBuffer;
+
+    static_assert((Features & kNeedsFixedN) == 0,
+                  "SignalProcessorDyn does not support MinMaxWedge/Median/SlidingDft/ExternalBuffer");
+    static_assert((SIGNAL_PROCESSOR_DYN_ALIGN & (SIGNAL_PROCESSOR_DYN_ALIGN - 1)) == 0,
+                  "SIGNAL_PROCESSOR_DYN_ALIGN must be a power of two");
+
+    // Буфер належить арені: копія ділила б його з оригіналом
+    SignalProcessorDyn(const SignalProcessorDyn&);
+    SignalProcessorDyn& operator=(const SignalProcessorDyn&);
+
+public:
+    /** Вирівнювання буфера в арені */
+    static const size_t kBufferAlign = SIGNAL_PROCESSOR_DYN_ALIGN;
+
+    /** Неініціалізований процесор (add() до init() / attach() не дозволений) */
+    SignalProcessorDyn() : Core((T*)0) {}
+
+    /** Байт арени на процесор ємності capacity (з найгіршим вирівнюванням) */
+    static size_t getRequiredBytes(uint32_t capacity) {
+        return (size_t)capacity * sizeof(T) + kBufferAlign - 1;
+    }
+
+    /**
+     * Виділення буфера з арени або пулу - один раз, при старті
+     * @param alloc Будь-який тип з void* allocate(size_t bytes, size_t align) (SignalArena)
+     * @param capacity Розмір вікна (2 до 2^31)
+     * @return false - арена вичерпана, capacity поза межами або процесор уже ініціалізований
+     */
+    template<typename Allocator>
+    bool init(Allocator& alloc, uint32_t capacity) {
+        if (isInitialized() || capacity < 2 || capacity > 0x80000000u) return false;
+        void* p = alloc.allocate((size_t)capacity * sizeof(T), kBufferAlign);
+        if (p == 0) return false;
+        return attach((T*)p, capacity);
+    }
+
+    /**
+     * Робота над готовим буфером (блок пулу, область DTCM/CCM)
+     * @param storage capacity значень; вміст не має значення
+     */
+    bool attach(T* storage, uint32_t capacity) {
+        if (storage == 0 || capacity < 2 || capacity > 0x80000000u) return false;
+        this->attachStorage(storage, capacity);
+        return true;
+    }
+
+    bool isInitialized() const { return this->getBuffer() != 0; }
+
+    /**
+     * Оператор += для зручного додавання
+     */
+    SignalProcessorDyn& operator+=(T value) {
+        this->add(value);
+        return *this;
+    }
+};
+
+#endif
@@ -0,0 +1,237 @@
+#ifndef SIGNAL_PROCESSOR_PAIR_HPP_
+#define SIGNAL_PROCESSOR_PAIR_HPP_
+
+#include "SignalProcessor.hpp"
+
+/**
+ * @brief Ковзна коваріація, кореляція і регресія двох синхронних каналів
+ *
+ * Призначення:
+ *  - Струм і напруга, два давачі одного вузла, вхід і вихід регулятора
+ *  - Зв'язок каналів за останні N спільних відліків за O(1) на add()
+ *
+ * Кожен канал - звичайний SignalProcessor (уся його статистика доступна через
+ * x()/y()). Пара додатково веде суму добутків Sxy з тим самим витісненням, що й
+ * add() каналу: з повним вікном віднімається добуток найстаріших значень, далі
+ * додається добуток нових. Разом із сумами і сумами квадратів каналів:
+ *   cov = (Sxy - Sx * Sy / n) / (n - 1)
+ *   r   = cov / sqrt(varX * varY)
+ *   slope = cov / varX,  intercept = meanY - slope * meanX   (y ≈ slope * x + intercept)
+ *   P = Sxy / n,  S = rmsX * rmsY,  PF = P / S               (потужність для x = u, y = i)
+ * З FloatAccumulator Sxy дрейфує так само, як суми каналів - recalculateSums() раз на
+ * кілька мільйонів значень або точніший акумулятор.
+ *
+ *   SignalProcessorPair<int16_t, 256> vi;
+ *   vi.add(voltage, current);
+ *   float r = vi.getCorrelation();
+ *   float ohms = vi.getSlope();          // ΔU / ΔI
+ *
+ * Шаблонні параметри - як у SignalProcessor (однакові для обох каналів);
+ * Features має містити SignalFeatures::Variance.
+ *
+ * Використання пам'яті: 2 * sizeof(SignalProcessor<T, N, ...>) + sizeof(Accumulator<T>)
+ */
+template<typename T, uint32_t N, uint32_t Features = SignalFeatures::Default,
+         template<typename> class Accumulator = FloatAccumulator>
+class SignalProcessorPair {
+public:
+    typedef SignalProcessor<T, N, Features, Accumulator> Channel;
+    typedef typename Channel::SizeType SizeType;
+
+    static_assert(Channel::kHasVariance, "SignalProcessorPair requires SignalFeatures::Variance");
+    static_assert(!Channel::kExternalBuffer,
+                  "SignalProcessorPair must see every sample (commitSamples() would bypass Sxy)");
+
+private:
+    typedef Accumulator<T> Acc;
+    typedef typename Acc::Term AccTerm;
+    typedef typename Acc::Value AccValue;
+
+    Channel x_;
+    Channel y_;
+    Acc sumXy_;             // Сума добутків x * y по вікну
+
+    static AccTerm product(T a, T b) { return (AccTerm)a * (AccTerm)b; }
+
+public:
+    // ========================================
+    // ДОДАВАННЯ ДАНИХ
+    // ========================================
+
+    /**
+     * Додавання пари синхронних значень
+     * @param xValue Значення першого каналу
+     * @param yValue Значення другого каналу
+     */
+    void add(T xValue, T yValue) {
+        evictOldest();
+        x_.add(xValue);
+        y_.add(yValue);
+        sumXy_.add(product(xValue, yValue));
+    }
+
+    /**
+     * Додавання пари з часовою міткою (однакова для обох каналів)
+     */
+    void add(T xValue, T yValue, uint32_t time) {
+        evictOldest();
+        x_.add(xValue, time);
+        y_.add(yValue, time);
+        sumXy_.add(product(xValue, yValue));
+    }
+
+    /**
+     * Пакетне додавання двох паралельних блоків (n значень кожен)
+     * Канали оновлюються своїм addBlock(); при n >= N Sxy перераховується по вікну
+     */
+    void addBlock(const T* xs, const T* ys, size_t n) {
+        blockProducts(xs, ys, n);
+        x_.addBlock(xs, n);
+        y_.addBlock(ys, n);
+        if (n >= N) recalculateProducts();
+    }
+
+    /**
+     * Пакетне додавання з рівномірними часовими мітками
+     * @param startTime Мітка першої пари в тіках
+     * @param period Період дискретизації
+     */
+    void addBlock(const T* xs, const T* ys, size_t n, uint32_t startTime, uint32_t period) {
+        blockProducts(xs, ys, n);
+        x_.addBlock(xs, n, startTime, period);
+        y_.addBlock(ys, n, startTime, period);
+        if (n >= N) recalculateProducts();
+    }
+
+    /**
+     * Повне скидання обох каналів
+     */
+    void reset() {
+        x_.reset();
+        y_.reset();
+        sumXy_.reset();
+    }
+
+    /**
+     * Перерахунок Sxy і сум обох каналів по вікну (усуває дрейф FloatAccumulator)
+     */
+    void recalculateSums() {
+        x_.recalculateSums();
+        y_.recalculateSums();
+        recalculateProducts();
+    }
+
+    // ========================================
+    // СПІЛЬНА СТАТИСТИКА
+    // ========================================
+
+    /** Вибіркова коваріація (незміщена оцінка) */
+    float getCovariance() const {
+        const SizeType n = x_.getCount();
+        if (n <= 1) return 0.0f;
+        AccValue cov = (sumXy_.value() - x_.sumValue() * y_.sumValue() / (AccValue)n) / (AccValue)(n - 1);
+        return (float)cov;
+    }
+
+    /**
+     * Коефіцієнт кореляції Пірсона в [-1, 1]
+     * 0, якщо один із каналів сталий (дисперсія 0)
+     */
+    float getCorrelation() const {
+        float varX = x_.getVariance();
+        float varY = y_.getVariance();
+        if (varX <= 0.0f || varY <= 0.0f) return 0.0f;
+        float r = getCovariance() / sp_detail::mathSqrt(varX * varY);
+        // Округлення сум не повинно виводити r за межі
+        if (r > 1.0f) return 1.0f;
+        if (r < -1.0f) return -1.0f;
+        return r;
+    }
+
+    /** Нахил лінійної регресії y за x (0, якщо x сталий) */
+    float getSlope() const {
+        float varX = x_.getVariance();
+        return (varX > 0.0f) ? getCovariance() / varX : 0.0f;
+    }
+
+    /** Зсув лінійної регресії: y ≈ getSlope() * x + getIntercept() */
+    float getIntercept() const {
+        return y_.getMean() - getSlope() * x_.getMean();
+    }
+
+    /**
+     * Середня (активна) потужність: Sxy / n
+     * Для x - напруги і y - струму в одиницях АЦП - у добутку їх масштабів
+     */
+    float getMeanPower() const {
+        const SizeType n = x_.getCount();
+        return (n > 0) ? (float)(sumXy_.value() / (AccValue)n) : 0.0f;
+    }
+
+    /** Повна потужність: RMS(x) * RMS(y) (корені - з кешу каналів зі StatsCache) */
+    float getApparentPower() const {
+        return x_.getRms() * y_.getRms();
+    }
+
+    /** Коефіцієнт потужності: getMeanPower() / getApparentPower(), [-1, 1] */
+    float getPowerFactor() const {
+        float s = getApparentPower();
+        if (s <= 0.0f) return 0.0f;
+        float pf = getMeanPower() / s;
+        if (pf > 1.0f) return 1.0f;
+        if (pf < -1.0f) return -1.0f;
+        return pf;
+    }
+
+    /** Кількість пар у вікні (0 до N) */
+    SizeType getCount() const { return x_.getCount(); }
+
+    /** Чи заповнене вікно */
+    bool isFull() const { return x_.isFull(); }
+
+    // ========================================
+    // КАНАЛИ
+    // ========================================
+
+    /**
+     * Канали для налаштування і власної статистики (getMean(), getStdDev(), фільтри...)
+     * Значення додавати тільки через пару - інакше Sxy розійдеться з вікнами
+     */
+    Channel& x() { return x_; }
+    Channel& y() { return y_; }
+    const Channel& x() const { return x_; }
+    const Channel& y() const { return y_; }
+
+private:
+    /** Повне вікно: добуток пари, яку витіснить наступне add() */
+    void evictOldest() {
+        if (x_.isFull()) sumXy_.sub(product(x_.getLatest(N - 1), y_.getLatest(N - 1)));
+    }
+
+    /**
+     * Sxy для блоку до оновлення каналів (n < N; більший блок перераховується після)
+     * i-та нова пара витісняє пару з логічним індексом count + i - N поточного вікна
+     */
+    void blockProducts(const T* xs, const T* ys, size_t n) {
+        if (n >= N) return;
+        const RingView<T> vx = x_.getView();
+        const RingView<T> vy = y_.getView();
+        const uint32_t count = vx.size();
+        for (size_t i = 0; i < n; i++) {
+            if (count + i >= N) {
+                uint32_t k = (uint32_t)(count + i - N);
+                sumXy_.sub(product(vx[k], vy[k]));
+            }
+            sumXy_.add(product(xs[i], ys[i]));
+        }
+    }
+
+    void recalculateProducts() {
+        const RingView<T> vx = x_.getView();
+        const RingView<T> vy = y_.getView();
+        sumXy_.reset();
+        for (uint32_t i = 0; i < vx.size(); i++) sumXy_.add(product(vx[i], vy[i]));
+    }
+};
+
+#endif
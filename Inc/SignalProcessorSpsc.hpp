@@ -0,0 +1,159 @@
+#ifndef SIGNAL_PROCESSOR_SPSC_HPP_
+#define SIGNAL_PROCESSOR_SPSC_HPP_
+
+#include "SignalProcessor.hpp"
+
+/**
+ * @brief Режим один виробник / один споживач (SPSC) для буферів, які наповнює ISR
+ *
+ * Призначення:
+ *  - Переривання АЦП/DMA додає значення, головний цикл читає статистику
+ *  - Без критичних секцій і без маскування переривань
+ *
+ * Виробник (ISR) викликає тільки push(): запис значення у вхідну чергу та
+ * публікація індексу з release-семантикою - кілька інструкцій, без статистики.
+ * Споживач (головний цикл) викликає stats(): нові значення з черги ліниво
+ * згортаються у звичайний SignalProcessor (не більше двох addBlock()), після
+ * чого всі getter-и (включно з перерахунком min/max) працюють тільки в
+ * контексті споживача. Стан статистики ISR не чіпає взагалі.
+ *
+ * Якщо черга переповнена (споживач давно не викликав stats()), push() відкидає
+ * значення і збільшує лічильник getOverrunCount().
+ *
+ * Атомарність: __atomic вбудовані функції GCC/Clang над 32-бітними індексами
+ * (на Cortex-M - звичайні LDR/STR + DMB, без LDREX/STREX).
+ *
+ * Шаблонні параметри:
+ *   T — тип даних
+ *   N — розмір вікна статистики
+ *   Depth — глибина вхідної черги (степінь двійки): максимум значень між викликами stats()
+ *   Features, Accumulator — як у SignalProcessor
+ *
+ * Використання пам'яті: sizeof(SignalProcessor<T, N, ...>) + Depth * (sizeof(T) + 4) + 16 байт
+ */
+template<typename T, uint32_t N, uint32_t Depth = 32,
+         uint32_t Features = SignalFeatures::Default,
+         template<typename> class Accumulator = FloatAccumulator>
+class SignalProcessorSpsc {
+    static_assert(Depth >= 2 && (Depth & (Depth - 1)) == 0, "Queue depth must be a power of two");
+
+public:
+    typedef SignalProcessor<T, N, Features, Accumulator> Processor;
+
+private:
+    static const uint32_t kMask = Depth - 1;
+
+    Processor processor_;       // Статистика - належить тільки споживачу
+
+    // Вхідна черга: пише тільки виробник, читає тільки споживач
+    T pending_[Depth];
+    uint32_t pendingTime_[Depth];
+    uint32_t head_;             // Лічильник записаних значень (пише виробник)
+    uint32_t tail_;             // Лічильник згорнутих значень (пише споживач)
+    uint32_t overruns_;         // Відкинуті значення (пише виробник)
+    uint32_t lastPushTime_;     // Мітка останнього push() (тільки виробник)
+
+public:
+    /**
+     * Конструктор з порожньою чергою
+     */
+    SignalProcessorSpsc() : head_(0), tail_(0), overruns_(0), lastPushTime_(0) {}
+
+    // ========================================
+    // ВИРОБНИК (ISR)
+    // ========================================
+
+    /**
+     * Додавання значення без часової мітки з контексту переривання
+     * У черзі зберігається мітка попереднього push(): нульовий інтервал не дає
+     * кроку похідної/інтегратора (крім режиму setSamplePeriod() процесора)
+     * @param value Нове значення
+     * @return false, якщо черга переповнена і значення відкинуто
+     */
+    bool push(T value) {
+        return push(value, lastPushTime_);
+    }
+
+    /**
+     * Додавання значення з контексту переривання
+     * @param value Нове значення
+     * @param time Часова мітка в тіках часової бази процесора (типово мс)
+     * @return false, якщо черга переповнена і значення відкинуто
+     */
+    bool push(T value, uint32_t time) {
+        uint32_t head = head_;   // Змінюється тільки тут
+        uint32_t tail = __atomic_load_n(&tail_, __ATOMIC_ACQUIRE);
+        if (head - tail >= Depth) {
+            __atomic_store_n(&overruns_, overruns_ + 1, __ATOMIC_RELAXED);
+            return false;
+        }
+        pending_[head & kMask] = value;
+        pendingTime_[head & kMask] = time;
+        lastPushTime_ = time;
+        // Значення стає видимим споживачу тільки після запису в комірку
+        __atomic_store_n(&head_, head + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    // ========================================
+    // СПОЖИВАЧ (головний цикл)
+    // ========================================
+
+    /**
+     * Згортання всіх опублікованих значень у статистику
+     * @return Кількість згорнутих значень
+     */
+    uint32_t poll() {
+        uint32_t tail = tail_;   // Змінюється тільки тут
+        uint32_t head = __atomic_load_n(&head_, __ATOMIC_ACQUIRE);
+        uint32_t n = head - tail;
+        if (n == 0) return 0;
+
+        // Не більше двох суцільних сегментів черги
+        uint32_t pos = tail & kMask;
+        uint32_t first = (n < Depth - pos) ? n : Depth - pos;
+        processor_.addBlock(pending_ + pos, first, pendingTime_ + pos);
+        if (first < n) {
+            processor_.addBlock(pending_, n - first, pendingTime_);
+        }
+
+        // Комірки звільняються для виробника тільки після прочитання
+        __atomic_store_n(&tail_, head, __ATOMIC_RELEASE);
+        return n;
+    }
+
+    /**
+     * Актуальна статистика: згортає нові значення і повертає процесор
+     * Викликати тільки з контексту споживача
+     */
+    Processor& stats() {
+        poll();
+        return processor_;
+    }
+
+    /**
+     * Процесор без згортання черги (наприклад, для налаштування параметрів)
+     */
+    Processor& processor() { return processor_; }
+
+    /** Кількість опублікованих, але ще не згорнутих значень */
+    uint32_t getPendingCount() const {
+        return __atomic_load_n(&head_, __ATOMIC_ACQUIRE) - tail_;
+    }
+
+    /** Кількість значень, відкинутих через переповнення черги */
+    uint32_t getOverrunCount() const {
+        return __atomic_load_n(&overruns_, __ATOMIC_RELAXED);
+    }
+
+    /**
+     * Скидання статистики та черги з контексту споживача
+     * Значення, опубліковані до виклику, відкидаються
+     */
+    void reset() {
+        __atomic_store_n(&tail_, __atomic_load_n(&head_, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+        processor_.reset();
+    }
+};
+
+#endif
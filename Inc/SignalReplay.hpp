@@ -0,0 +1,327 @@
+#ifndef SIGNAL_REPLAY_HPP_
+#define SIGNAL_REPLAY_HPP_
+
+#include "SignalProcessor.hpp"
+
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * @brief Офлайн-відтворення записаних захоплень (host, POSIX)
+ *
+ * SignalCaptureReader<T> відображає в пам'ять сирий файл семплів (int16_t, float, ...,
+ * без заголовка, порядок байтів платформи) і, опційно, окремий стовпець міток
+ * часу (uint32_t на семпл). Фрагменти по сторінці пам'яті йдуть в addBlock()
+ * вказівниками прямо у відображення - без fread() і проміжних копій. Ядро читає
+ * файл наперед за підказкою madvise(MADV_SEQUENTIAL), а пройдені сторінки
+ * звільняються (MADV_DONTNEED), тому захоплення більше за RAM не вимиває кеш.
+ *
+ * SignalStatsWriter<T> записує знімки getStats() по вікнах у стовпчиковий
+ * бінарний файл (групи рядків, див. нижче).
+ *
+ *   SignalProcessor<int16_t, 1000> p;
+ *   SignalCaptureReader<int16_t> capture;
+ *   SignalStatsWriter<int16_t> out;
+ *   if (capture.open("sensor.raw", "sensor.t32") && out.open("sensor.stats")) {
+ *       capture.replay(p, out, 1000);      // Знімок після кожних 1000 семплів
+ *       out.close();
+ *   }
+ *
+ * Лише для host: POSIX mmap/madvise, stdio для запису.
+ */
+
+/** Відображений у пам'ять файл, лише читання */
+class SignalMappedFile {
+public:
+    /** Пройдені сторінки звільняються порціями не менше цієї (один madvise на порцію) */
+    static const size_t kReleaseBytes = 1u << 20;
+
+    SignalMappedFile() : data_(0), size_(0), released_(0) {}
+    ~SignalMappedFile() { close(); }
+
+    /** Відображення файлу; false - файл не відкрито або порожній */
+    bool open(const char* path) {
+        close();
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+            ::close(fd);
+            return false;
+        }
+        void* p = mmap(0, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);       // Відображення тримає файл саме
+        if (p == MAP_FAILED) return false;
+        data_ = (const uint8_t*)p;
+        size_ = (size_t)st.st_size;
+        madvise((void*)data_, size_, MADV_SEQUENTIAL);
+        return true;
+    }
+
+    void close() {
+        if (data_) munmap((void*)data_, size_);
+        data_ = 0;
+        size_ = 0;
+        released_ = 0;
+    }
+
+    /** Сторінки [0, end) більше не потрібні - ядро може їх звільнити */
+    void release(size_t end) {
+        end -= end % pageSize();
+        if (!data_ || end < released_ + kReleaseBytes) return;
+        madvise((void*)(data_ + released_), end - released_, MADV_DONTNEED);
+        released_ = end;
+    }
+
+    /** Наступне release() - знову з початку файлу (після повторного читання) */
+    void rewind() { released_ = 0; }
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool isOpen() const { return data_ != 0; }
+
+    static size_t pageSize() {
+        long page = sysconf(_SC_PAGESIZE);
+        return (page > 0) ? (size_t)page : 4096;
+    }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t released_;       // Межа вже звільнених сторінок
+
+    SignalMappedFile(const SignalMappedFile&);
+    SignalMappedFile& operator=(const SignalMappedFile&);
+};
+
+/**
+ * Джерело семплів з файлу захоплення
+ * T - тип семпла у файлі (той самий, що у процесора)
+ */
+template<typename T>
+class SignalCaptureReader {
+public:
+    SignalCaptureReader() : count_(0), position_(0), chunk_(0) {}
+
+    /**
+     * Відкриття захоплення
+     * @param samplesPath Сирі семпли T підряд
+     * @param timesPath Стовпець міток uint32_t (0 - без міток); кількість має збігатися
+     * @param chunkSamples Семплів на фрагмент (0 - сторінка пам'яті)
+     * @return false - файл не відкрито, розмір не кратний sizeof(T) або стовпці різної довжини
+     */
+    bool open(const char* samplesPath, const char* timesPath = 0, size_t chunkSamples = 0) {
+        close();
+        if (!samples_.open(samplesPath) || samples_.size() % sizeof(T) != 0) {
+            close();
+            return false;
+        }
+        count_ = samples_.size() / sizeof(T);
+        if (timesPath && (!times_.open(timesPath) || times_.size() != count_ * sizeof(uint32_t))) {
+            close();
+            return false;
+        }
+        chunk_ = chunkSamples ? chunkSamples : SignalMappedFile::pageSize() / sizeof(T);
+        if (chunk_ == 0) chunk_ = 1;
+        return true;
+    }
+
+    void close() {
+        samples_.close();
+        times_.close();
+        count_ = position_ = 0;
+    }
+
+    size_t getSampleCount() const { return count_; }
+    size_t getPosition() const { return position_; }
+    bool hasTimes() const { return times_.isOpen(); }
+
+    /** Повернення на початок захоплення */
+    void rewind() {
+        position_ = 0;
+        samples_.rewind();
+        times_.rewind();
+    }
+
+    /**
+     * Наступний фрагмент без копіювання: вказівники у відображення
+     * @param samples Початок фрагмента
+     * @param times Мітки фрагмента (0 без стовпця міток)
+     * @param limit Не більше стількох семплів (0 - без обмеження, тільки фрагмент)
+     * @return Кількість семплів (0 - кінець файлу)
+     */
+    size_t next(const T*& samples, const uint32_t*& times, size_t limit = 0) {
+        size_t n = count_ - position_;
+        if (n > chunk_) n = chunk_;
+        if (limit && n > limit) n = limit;
+        samples = (const T*)samples_.data() + position_;
+        times = hasTimes() ? (const uint32_t*)times_.data() + position_ : 0;
+        position_ += n;
+        return n;
+    }
+
+    /** Прогін решти захоплення через процесор; повертає кількість семплів */
+    template<typename P>
+    size_t replay(P& p) {
+        size_t total = 0;
+        const T* s;
+        const uint32_t* t;
+        for (size_t n; (n = next(s, t)) != 0; total += n) {
+            feed(p, s, t, n);
+        }
+        return total;
+    }
+
+    /**
+     * Прогін зі знімком статистики після кожних window семплів
+     * Sink - будь-який тип з write(const P::Stats&, uint64_t endSample) (SignalStatsWriter)
+     * Фрагменти ріжуться по межах вікон; неповне останнє вікно теж записується
+     */
+    template<typename P, typename Sink>
+    size_t replay(P& p, Sink& sink, size_t window) {
+        if (window == 0) return replay(p);
+        size_t total = 0;
+        size_t filled = 0;
+        const T* s;
+        const uint32_t* t;
+        for (size_t n; (n = next(s, t, window - filled)) != 0; total += n) {
+            feed(p, s, t, n);
+            filled += n;
+            if (filled == window) {
+                sink.write(p.getStats(), (uint64_t)position_);
+                filled = 0;
+            }
+        }
+        if (filled > 0) sink.write(p.getStats(), (uint64_t)position_);
+        return total;
+    }
+
+private:
+    SignalMappedFile samples_;
+    SignalMappedFile times_;
+    size_t count_;          // Семплів у файлі
+    size_t position_;       // Наступний семпл
+    size_t chunk_;          // Семплів на фрагмент
+
+    template<typename P>
+    void feed(P& p, const T* s, const uint32_t* t, size_t n) {
+        if (t) {
+            p.addBlock(s, n, t);
+            times_.release((size_t)((const uint8_t*)(t + n) - times_.data()));
+        } else {
+            p.addBlock(s, n);
+        }
+        samples_.release((size_t)((const uint8_t*)(s + n) - samples_.data()));
+    }
+};
+
+/**
+ * Стовпчиковий запис знімків статистики
+ *
+ * Формат (порядок байтів платформи):
+ *   Заголовок, 16 байт: "SPST", uint16 версія (1), uint8 sizeof(T),
+ *                       uint8 тип T (0 - знаковий цілий, 1 - беззнаковий, 2 - float),
+ *                       uint32 kGroupRows, uint32 0
+ *   Групи рядків до кінця файлу: uint32 rows, далі стовпці по rows значень:
+ *     uint64 endSample, uint32 count, float mean, variance, stdDev, cv, range, ema, T min, T max
+ * Стовпець читається одним суцільним шматком групи (numpy.frombuffer, Arrow, Parquet-конвертери)
+ */
+template<typename T>
+class SignalStatsWriter {
+public:
+    static const uint16_t kVersion = 1;
+    static const uint32_t kGroupRows = 4096;     // Рядків у групі (буфер ~190 КБ для int16_t)
+
+    SignalStatsWriter() : file_(0), rows_(0), ok_(false) {}
+    ~SignalStatsWriter() { close(); }
+
+    /** Створення файлу і запис заголовка */
+    bool open(const char* path) {
+        close();
+        file_ = fopen(path, "wb");
+        if (!file_) return false;
+        uint8_t header[16] = { 'S', 'P', 'S', 'T' };
+        header[4] = (uint8_t)(kVersion & 0xFF);
+        header[5] = (uint8_t)(kVersion >> 8);
+        header[6] = (uint8_t)sizeof(T);
+        header[7] = ((T)0.5 != (T)0) ? 2 : (((T)-1 < (T)0) ? 0 : 1);
+        for (int i = 0; i < 4; i++) header[8 + i] = (uint8_t)(kGroupRows >> (8 * i));
+        ok_ = fwrite(header, 1, sizeof(header), file_) == sizeof(header);
+        return ok_;
+    }
+
+    /** Рядок: знімок після семпла endSample (нумерація з 1 від початку захоплення) */
+    void write(const SignalStats<T>& s, uint64_t endSample) {
+        if (!file_) return;
+        endSample_[rows_] = endSample;
+        count_[rows_] = s.count;
+        mean_[rows_] = s.mean;
+        variance_[rows_] = s.variance;
+        stdDev_[rows_] = s.stdDev;
+        cv_[rows_] = s.cv;
+        range_[rows_] = s.range;
+        ema_[rows_] = s.ema;
+        min_[rows_] = s.min;
+        max_[rows_] = s.max;
+        if (++rows_ == kGroupRows) flush();
+    }
+
+    /** Запис накопиченої групи рядків; false - помилка запису (тепер або раніше) */
+    bool flush() {
+        if (!file_) return false;
+        if (rows_ > 0) {
+            uint32_t rows = rows_;
+            put(&rows, 1);
+            put(endSample_, rows);
+            put(count_, rows);
+            put(mean_, rows);
+            put(variance_, rows);
+            put(stdDev_, rows);
+            put(cv_, rows);
+            put(range_, rows);
+            put(ema_, rows);
+            put(min_, rows);
+            put(max_, rows);
+            rows_ = 0;
+        }
+        return ok_;
+    }
+
+    /** Запис решти рядків і закриття; false - дані записано не повністю */
+    bool close() {
+        if (!file_) return false;
+        flush();
+        if (fclose(file_) != 0) ok_ = false;
+        file_ = 0;
+        return ok_;
+    }
+
+private:
+    FILE* file_;
+    uint32_t rows_;
+    bool ok_;
+
+    uint64_t endSample_[kGroupRows];
+    uint32_t count_[kGroupRows];
+    float mean_[kGroupRows];
+    float variance_[kGroupRows];
+    float stdDev_[kGroupRows];
+    float cv_[kGroupRows];
+    float range_[kGroupRows];
+    float ema_[kGroupRows];
+    T min_[kGroupRows];
+    T max_[kGroupRows];
+
+    template<typename U>
+    void put(const U* column, uint32_t rows) {
+        if (fwrite(column, sizeof(U), rows, file_) != rows) ok_ = false;
+    }
+
+    SignalStatsWriter(const SignalStatsWriter&);
+    SignalStatsWriter& operator=(const SignalStatsWriter&);
+};
+
+#endif
@@ -0,0 +1,62 @@
+/**
+ * Процесор, заповнений під час компіляції (C++20), як стартовий стан на виконанні:
+ * копія і сама константа дають ту саму статистику, що й процесор, заповнений
+ * на виконанні, і далі коректно оновлюються add() / addBlock()
+ */
+#include <stdint.h>
+
+#include "SignalProcessor.hpp"
+#include "CheckSupport.hpp"
+
+namespace {
+
+typedef SignalProcessor<int16_t, 4> Processor;
+
+/** Повне вікно: constexpr-змінна не може містити неініціалізованих комірок буфера */
+constexpr Processor warm() {
+    Processor p;
+    for (int16_t v = 96; v <= 103; v++) p.add(v);
+    return p;
+}
+
+constexpr Processor kWarm = warm();
+static_assert(kWarm.getMin() == 100 && kWarm.getMax() == 103, "compile-time min/max");
+
+/** Той самий процесор і еталон отримують однакові значення */
+void feed(Processor& p, Processor& reference, int16_t v) {
+    p.add(v);
+    reference.add(v);
+    SP_CHECK(p.getMin() == reference.getMin());
+    SP_CHECK(p.getMax() == reference.getMax());
+    SP_CHECK(p.getMean() == reference.getMean());
+    SP_CHECK(p.getStats().min == reference.getStats().min);
+}
+
+} // namespace
+
+int main() {
+    Processor reference;
+    for (int16_t v = 96; v <= 103; v++) reference.add(v);
+
+    SP_CHECK(kWarm.getMin() == 100);
+    SP_CHECK(kWarm.getMax() == 103);
+
+    Processor p = kWarm;
+    SP_CHECK(p.getMin() == 100);
+    SP_CHECK(p.getMax() == 103);
+    SP_CHECK(p.getStats().max == 103);
+
+    feed(p, reference, 150);
+    SP_CHECK(p.getMin() == 101 && p.getMax() == 150);
+    feed(p, reference, 90);
+
+    // Витіснення екстремумів після заповнення вікна
+    for (int i = 0; i < 20; i++) feed(p, reference, (int16_t)(200 - 7 * i));
+
+    Processor q = kWarm;
+    const int16_t block[3] = { 50, 60, 70 };
+    q.addBlock(block, 3);
+    SP_CHECK(q.getMin() == 50 && q.getMax() == 103);
+
+    return sp_check::result("CheckConstexprWarmStart");
+}
@@ -0,0 +1,68 @@
+/**
+ * ExactAccumulator: суми вікна після будь-якої суміші add() / addBlock() /
+ * recalculateSums() збігаються з прямим перерахунком в int64_t
+ * (зокрема для 32-бітних T, де ядра addBlock() сумують у double)
+ */
+#include <stdint.h>
+
+#include "SignalProcessor.hpp"
+#include "CheckSupport.hpp"
+
+namespace {
+
+template<typename T, uint32_t N>
+void checkWindow(int64_t base, uint32_t spread) {
+    SignalProcessor<T, N, SignalFeatures::Default, ExactAccumulator> p;
+    T window[N];            // Еталонне кільце
+    uint32_t count = 0, index = 0;
+    int mismatches = 0;
+
+    for (int step = 0; step < 3000; step++) {
+        T block[3 * N];
+        uint32_t mode = sp_check::random() % 3;
+        uint32_t n = (mode == 0) ? 1 : sp_check::random() % ((mode == 1) ? 9 : 3 * N);
+        for (uint32_t i = 0; i < n; i++) block[i] = (T)(base + (int64_t)(sp_check::random() % spread));
+
+        if (mode == 0) p.add(block[0]);
+        else p.addBlock(block, n);
+        if (step == 1500) p.recalculateSums();
+
+        for (uint32_t i = 0; i < n; i++) {
+            window[index] = block[i];
+            index = (index + 1) % N;
+            if (count < N) count++;
+        }
+
+        int64_t sum = 0, sumSq = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            sum += (int64_t)window[i];
+            sumSq += (int64_t)window[i] * (int64_t)window[i];
+        }
+        SignalSummary<T> s = p.summary();
+        if (s.count != count || s.sum != (double)sum || s.sumSq != (double)sumSq) mismatches++;
+    }
+    SP_CHECK(mismatches == 0);
+}
+
+/** Блок 24-бітних значень (сума квадратів > 2^53), далі витіснення по одному */
+void checkEvictAfterBlock() {
+    SignalProcessor<int32_t, 256, SignalFeatures::Default, ExactAccumulator> p;
+    int32_t block[256];
+    for (int32_t i = 0; i < 256; i++) block[i] = (1 << 23) - 1 - i;
+    p.addBlock(block, 256);
+    for (int i = 0; i < 256; i++) p.add(5);
+    SP_CHECK(p.summary().sumSq == 6400.0);
+    SP_CHECK(p.getVariance() == 0.0f);
+}
+
+} // namespace
+
+int main() {
+    checkWindow<int32_t, 256>((1 << 23) - 4000, 4000);
+    checkWindow<int32_t, 100>(-(1 << 23), 1u << 24);
+    checkWindow<uint32_t, 64>(1 << 24, 1000);
+    checkWindow<int16_t, 37>(-30000, 60000);
+    checkWindow<uint16_t, 4096>(0, 4096);
+    checkEvictAfterBlock();
+    return sp_check::result("CheckExactAccumulator");
+}
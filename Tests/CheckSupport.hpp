@@ -0,0 +1,40 @@
+#ifndef SIGNAL_PROCESSOR_CHECK_SUPPORT_HPP_
+#define SIGNAL_PROCESSOR_CHECK_SUPPORT_HPP_
+
+#include <stdio.h>
+
+/**
+ * Мінімальні перевірки без фреймворку: SP_CHECK друкує провалену умову,
+ * sp_check::result() - код виходу main()
+ */
+namespace sp_check {
+
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+inline int result(const char* name) {
+    printf("%s: %s (%d)\n", name, failures() == 0 ? "OK" : "FAILED", failures());
+    return failures() == 0 ? 0 : 1;
+}
+
+/** Детермінований псевдовипадковий генератор (xorshift32) - однаковий на всіх платформах */
+inline uint32_t random() {
+    static uint32_t state = 2463534242u;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+} // namespace sp_check
+
+#define SP_CHECK(cond) do { \
+    if (!(cond)) { \
+        printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+        sp_check::failures()++; \
+    } \
+} while (0)
+
+#endif